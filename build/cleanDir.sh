@@ -6,6 +6,9 @@ rm -rf cmake_install.cmake
 rm -rf liblibgen.so
 rm -rf fdgen
 rm -rf boxgen
+rm -rf valgen
+rm -rf txextract
+rm -rf txmerge
 rm -rf CMakeFiles
 rm -rf *.root
 rm -rf *.tx
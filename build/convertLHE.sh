@@ -10,18 +10,20 @@ fi
 
 cmsEnergyDiv2=2510
 
-for inputFile in `ls output/slight*.tx`
+lheComp=""  # set to .gz or .zst for compressed LHE output
+
+for inputFile in `ls output/slight*.tx output/slight*.tx.gz output/slight*.tx.zst 2>/dev/null`
 do
     echo $inputFile
 
     baseFileName=`basename $inputFile`
 
-    outputFile=${baseFileName%.tx}  # remove `.tx`
+    outputFile=${baseFileName%.tx*}  # remove `.tx` with possible compression suffix
 
     echo $outputFile
 
     root -l -b << EOF
-    .x convert_SL2LHE.C+("$inputFile","lheFiles/$outputFile",$cmsEnergyDiv2,$cmsEnergyDiv2)
+    .x convert_SL2LHE.C+("$inputFile","lheFiles/$outputFile$lheComp",$cmsEnergyDiv2,$cmsEnergyDiv2)
     .q
 EOF
 
@@ -0,0 +1,13 @@
+#!/bin/bash
+
+# statistical equivalence of a candidate generation path with the reference
+# usage: ./validate.sh <candidate> [input] [nev]
+
+candidate=$1
+inFile=${2:-/afs/cern.ch/user/s/shuaiy/public/starlight/decayPsi2S/testFiles/slight_CohPsi2S_4Feeddown_0001.out}
+nev=${3:-100000}
+
+./valgen -run ref $inFile val_ref.root $nev || exit 2
+./valgen -run $candidate $inFile val_$candidate.root $nev || exit 2
+
+./valgen -compare val_ref.root val_$candidate.root
@@ -0,0 +1,58 @@
+#ifndef TAccMap_h
+#define TAccMap_h
+
+// dilepton acceptance map in (pT^2, y, cos(theta)), the map is built from
+// generated and accepted decays filled in parallel slots, stored in a compact
+// binary file and evaluated with trilinear interpolation between bin centers
+
+#include <vector>
+#include <string>
+#include "Rtypes.h"
+
+class TParticle;
+
+class TAccMap {
+
+public:
+
+  TAccMap();
+  TAccMap(Int_t npt2, Double_t pt2min, Double_t pt2max, Int_t ny, Double_t ymin, Double_t ymax,
+    Int_t ncth, Double_t cthmin=-1, Double_t cthmax=1);
+
+  static void Vars(const TParticle *d0, const TParticle *d1, Double_t *val);
+
+  void SetNSlots(unsigned int nslot);
+  void Fill(unsigned int slot, const Double_t *val, bool accepted);
+  void Merge();
+
+  bool Save(const std::string& name) const;
+  bool Load(const std::string& name);
+  void Write(const char *name="hAcc") const;
+
+  Double_t Eval(Double_t pt2, Double_t y, Double_t cth) const;
+  Double_t Eval(const Double_t *val) const { return Eval(val[0], val[1], val[2]); }
+
+  unsigned long long GetNTrials() const { return fNtrials; }
+
+private:
+
+  int FindBin(int iaxis, Double_t val) const;
+  unsigned long Cell(int i0, int i1, int i2) const { return i0 + fNbins[0]*(i1 + fNbins[1]*(unsigned long)i2); }
+
+  int fNbins[3]; // bins in pT^2, y and cos(theta)
+  Double_t fMin[3], fMax[3]; // ranges along the axes
+  Double_t fScale[3]; // nbins/(max-min)
+
+  std::vector<Float_t> fEff; // acceptance in each bin
+  unsigned long long fNtrials; // generated decays used to build the map
+
+  struct Slot {
+    std::vector<unsigned int> ngen; // generated decays in each bin
+    std::vector<unsigned int> nacc; // accepted decays in each bin
+  };
+  std::vector<Slot> fSlot; // per-thread counters
+
+};//TAccMap
+
+#endif
+
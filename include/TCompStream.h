@@ -0,0 +1,114 @@
+#ifndef TCompStream_h
+#define TCompStream_h
+
+// transparent streaming of the text files (STARlight .out and .tx, LHE),
+// compression is selected by file extension: .gz for gzip, .zst for zstd,
+// plain text otherwise; output compression runs in a background thread
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdio>
+
+struct gzFile_s;
+struct ZSTD_DCtx_s;
+struct ZSTD_CCtx_s;
+
+class TCompStream {
+
+public:
+
+  enum EMode {kPlain=0, kGzip, kZstd};
+
+  static EMode ModeFromName(const std::string& name);
+  static std::string StripSuffix(const std::string& name, std::string& suffix);
+
+};//TCompStream
+
+class TCompInput {
+
+public:
+
+  TCompInput(const std::string& name);
+  ~TCompInput();
+
+  bool IsOpen() const { return fOpen; }
+  bool IsBad() const { return fBad; }
+  bool GetLine(std::string& line);
+  bool Seek(unsigned long long off);
+  unsigned long long Tell() const { return fBufStart + fPos; }
+  void Close();
+
+private:
+
+  size_t ReadRaw(char *buf, size_t len);
+  bool Fill();
+
+  TCompStream::EMode fMode; // compression of the input
+  bool fOpen; // input successfully opened
+  bool fEof; // end of input reached
+  bool fBad; // read error or truncated compressed input
+
+  FILE *fFile; // plain or zstd input
+  gzFile_s *fGz; // gzip input
+  ZSTD_DCtx_s *fZctx; // zstd decompression context
+
+  std::vector<char> fZbuf; // compressed zstd input
+  size_t fZpos, fZend; // position and end in compressed input
+  size_t fZhint; // zstd input still needed to complete the frame
+
+  std::vector<char> fBuf; // decompressed text
+  size_t fPos, fEnd; // position and end in decompressed text
+  unsigned long long fBufStart; // offset of decompressed text from the start of input
+
+};//TCompInput
+
+class TCompOutput {
+
+public:
+
+  TCompOutput(const std::string& name, size_t chunk=1<<20, size_t nqueue=4);
+  ~TCompOutput();
+
+  bool IsOpen() const { return fOpen; }
+  bool IsBad() const { return fBad; }
+  void Write(const std::string& str);
+  bool Close();
+
+  unsigned long long Tell() const { return fNbytes; }
+  TCompStream::EMode GetMode() const { return fMode; }
+
+private:
+
+  void Push();
+  void WriterLoop();
+  void WriteRaw(const char *buf, size_t len, bool last);
+
+  TCompStream::EMode fMode; // compression of the output
+  bool fOpen; // output successfully opened
+  std::atomic<bool> fBad; // write error, output is incomplete
+
+  FILE *fFile; // plain or zstd output
+  gzFile_s *fGz; // gzip output
+  ZSTD_CCtx_s *fZctx; // zstd compression context
+  std::vector<char> fZbuf; // compressed zstd output
+
+  std::string fChunk; // chunk being filled by the event loop
+  size_t fChunkSize; // chunk size handed to the writer thread
+  unsigned long long fNbytes; // uncompressed bytes written so far
+
+  std::deque<std::string> fQueue; // chunks waiting for the writer thread
+  size_t fMaxQueue; // maximal number of waiting chunks
+  std::mutex fMtx; // guards the queue
+  std::condition_variable fCondPush, fCondPop; // queue not full and not empty
+  bool fDone; // no more chunks will come
+  std::thread fThread; // writer thread
+
+};//TCompOutput
+
+#endif
+
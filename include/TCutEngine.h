@@ -0,0 +1,53 @@
+#ifndef TCutEngine_h
+#define TCutEngine_h
+
+// per-particle and per-event selection parsed once from a configuration,
+// evaluated in the generation loop before any output, with cut flow counters
+
+#include <vector>
+#include <string>
+#include "Rtypes.h"
+
+class TParticle;
+class TLorentzVector;
+
+class TCutEngine {
+
+public:
+
+  enum EScope {kLep=0, kAll, kAny, kPair, kEvent};
+  enum EVar {kEta=0, kPt, kY, kMass, kPdg, kPhi};
+
+  TCutEngine();
+
+  bool LoadConfig(const std::string& cfg);
+  bool AddCut(const std::string& line);
+
+  bool Accept(const std::vector<const TParticle*>& part);
+
+  void Print() const;
+  unsigned int GetNCuts() const { return fCuts.size(); }
+
+private:
+
+  struct Cut {
+    EScope scope; // particles the cut applies to
+    EVar var; // tested variable
+    Double_t vmin, vmax; // accepted interval, inclusive
+    bool abs; // test absolute value
+    std::string text; // cut as given in configuration
+  };
+
+  bool Pass(const Cut& cut, Double_t val) const;
+  Double_t Value(EVar var, const TParticle *part) const;
+  Double_t Value(EVar var, const TLorentzVector& vec) const;
+
+  std::vector<Cut> fCuts; // cuts in order of evaluation
+
+  unsigned long fNevt; // number of evaluated events
+  std::vector<unsigned long> fNpass; // events passing each cut and all before it
+
+};//TCutEngine
+
+#endif
+
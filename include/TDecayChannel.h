@@ -0,0 +1,111 @@
+#ifndef TDecayChannel_h
+#define TDecayChannel_h
+
+// one feed-down channel: decay of the parent in Pythia8 to the intermediate
+// vector meson, polarized decay of the vector meson to a lepton pair, selection
+// and output in .tx, tree or histograms; several channels can be fed from one
+// pass over the input, the Pythia8 decayer is shared among them
+
+class TPythia8Decayer;
+class TDecayPythia8;
+class TLorentzVector;
+class TClonesArray;
+class TDecayPolarized;
+class TParticle;
+class TFile;
+class TTree;
+class TCompOutput;
+class TTxIndex;
+class THistAccum;
+class TPolWeights;
+class TCutEngine;
+
+#include <vector>
+#include <string>
+#include "Rtypes.h"
+
+class TDecayChannel {
+
+public:
+
+  TDecayChannel(int parent, int vm, int lepton, const std::string& outp);
+  ~TDecayChannel();
+
+  void SetEtaRange(double etamin, double etamax);
+  bool SetCuts(const std::string& cfg);
+  bool SetHistConfig(const std::string& cfg);
+  bool SetPolConfig(const std::string& cfg);
+  void AddPolHypothesis(double lth, double lph, double ltp);
+  void SetTxIndex(const std::string& name) { fIdxName = name; }
+  void SetSeed(UInt_t seed);
+
+  void OpenOutput();
+  bool Decay(TPythia8Decayer *dec, TLorentzVector& vgen);
+  bool Decay(TDecayPythia8 *dec, TLorentzVector& vgen);
+  void WriteEvent();
+  void Print() const;
+
+  const std::vector<const TParticle*>& GetParticles() const { return fVecPol; }
+  const std::string& GetName() const { return fOutName; }
+  std::string GetTxName() const { return fOutName + ".tx" + fOutComp; }
+  int GetParent() const { return fParent; }
+
+private:
+
+  bool DecayParent(TPythia8Decayer *dec, TLorentzVector& vgen);
+  bool FinishDecay(const TLorentzVector& vvm);
+  bool PolarizedVM(const TLorentzVector& vvm);
+
+  void KeepFinalOnly();
+
+  bool AcceptDecay();
+  bool AcceptParticle(int idx);
+
+  void WriteStarlight();
+  void PutTxTrack(std::ostringstream &tx, unsigned int ipart);
+
+  int fParent; // PDG of decayed input particle
+  int fVm; // PDG of intermediate vector meson
+  int fLepton; // PDG of leptons from the vector meson
+
+  unsigned long fNdecay; // decays passing the selection
+  unsigned long fNfail; // input events where the vector meson was not produced
+
+  std::string fOutName; // output name without extension
+  std::string fOutComp; // compression suffix for .tx output
+  TCompOutput *fTxOut; //output in Starlight .tx format, plain or compressed
+  std::string fEvtline; // event line
+  std::string fVtxline; // vertex line
+  unsigned long fNtx; //output events to Starlight .tx format
+  std::string fIdxName; // name of event index for .tx output, no index when empty
+  TTxIndex *fTxIdx; // event index for .tx output
+
+  TClonesArray *fPart; // clones array for decay products from TPythia8Decayer
+  std::vector<TParticle> fProd; // vector meson and final products from direct Pythia8 decays
+  std::vector<const TParticle*> fOther; // parent decay products other than the vector meson
+  TDecayPolarized *fPol; // polarized vector meson decayer
+
+  std::vector<const TParticle*> fVecPol; // all parent decay products with polarized vector meson decay
+
+  bool fUseEta; // flag to use eta interval
+  double fEtaMin; // minimal pseudorapidity
+  double fEtaMax; // maximal pseudorapidity
+
+  TCutEngine *fCuts; // configured selection before the output
+
+  TFile *fRootOut; // output ROOT file
+  TTree *jGenTree; // output tree with vector meson kinematics
+  Double_t jGenPt, jGenPt2; // pT and pT^2
+  Double_t jGenY; // rapidity
+  Double_t jGenPhi; // azimuthal angle
+  Double_t jGenCosTheta; // polar decay angle of positive lepton in selected frame
+  Double_t jGenPhiDecay; // azimuthal decay angle of positive lepton in selected frame
+  std::vector<Double_t> jGenW; // weights for polarization hypotheses
+
+  TPolWeights *fPolW; // decay angles and polarization weights
+
+  THistAccum *fHist; // histograms instead of tree and .tx output
+
+};//TDecayChannel
+
+#endif
@@ -7,7 +7,6 @@
 
 class TParticle;
 class TLorentzVector;
-class TF1;
 class TRandom3;
 
 class TDecayPolarized {
@@ -17,13 +16,16 @@ public:
   TDecayPolarized(Int_t pdg=11, Double_t alpha=1);
   ~TDecayPolarized();
 
+  void SetSeed(UInt_t seed);
   void Generate(const TLorentzVector &vm);
   const TParticle* GetDecay(Int_t idx) const;
+  Double_t GetAlpha() const { return fAlpha; }
 
 private:
 
-  TF1 *fPol;  // decay products angular distribution
-  TRandom3 *fRand; // random generator for azimuthal angles
+  Double_t fAlpha; // decay products angular distribution, 1 + alpha*cos^2(theta)
+  Double_t fPolMax; // maximum of the angular distribution
+  TRandom3 *fRand; // random generator for polar and azimuthal angles
   Double_t fMass; // mass of decayed particle
   Int_t fPdg; // PDG of decayed particle
   std::vector<TParticle> fVec; // decay products
@@ -0,0 +1,50 @@
+#ifndef TDecayPythia8_h
+#define TDecayPythia8_h
+
+// parent decays with Pythia8 used directly, several copies of the parent are
+// decayed in one call and the native event record is searched for the vector
+// meson, only the vector meson and the final products of the accepted copy are
+// converted to TParticle, the vector meson itself is not decayed by Pythia8
+
+#include <vector>
+#include <string>
+#include "Rtypes.h"
+
+class TLorentzVector;
+class TParticle;
+
+namespace Pythia8 {
+  class Pythia;
+}
+
+class TDecayPythia8 {
+
+public:
+
+  TDecayPythia8(UInt_t seed=0);
+  ~TDecayPythia8();
+
+  void SetMaxCopies(int ncopy) { fMaxCopies = ncopy; }
+
+  bool Decay(int parent, int vm, const TLorentzVector& vgen, std::vector<TParticle>& prod);
+
+  unsigned long GetNCalls() const { return fNcalls; }
+  unsigned long GetNDecays() const { return fNtry; }
+
+private:
+
+  static std::string XmlDir();
+
+  int FindVM(int idx, int vm) const;
+  void Collect(int idx, int vm, std::vector<int>& keep) const;
+
+  Pythia8::Pythia *fPythia; // Pythia8 instance used only for decays
+
+  int fMaxCopies; // maximal number of parent copies in one call
+  unsigned long fNcalls; // calls to Pythia8 decays
+  unsigned long fNtry; // decayed parent copies
+  unsigned long fNacc; // copies with the vector meson
+
+};//TDecayPythia8
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef TEventBatch_h
+#define TEventBatch_h
+
+// batch of generated events in flat particle arrays, events are accessed
+// as read-only views into the arrays, TBatchSource is implemented by
+// the generators to fill the batches
+
+#include <vector>
+#include "Rtypes.h"
+
+class TEventBatch;
+class TParticle;
+
+class TEventView {
+
+public:
+
+  TEventView(const TEventBatch *batch, unsigned int iev): fBatch(batch), fIev(iev) {}
+
+  inline unsigned int GetNParticles() const;
+  inline Int_t Pdg(unsigned int i) const;
+  inline Double_t Px(unsigned int i) const;
+  inline Double_t Py(unsigned int i) const;
+  inline Double_t Pz(unsigned int i) const;
+  inline Double_t E(unsigned int i) const;
+  inline Double_t Weight() const;
+
+private:
+
+  const TEventBatch *fBatch; // batch with the event
+  unsigned int fIev; // event index in the batch
+
+};//TEventView
+
+class TEventBatch {
+
+public:
+
+  TEventBatch() { Clear(); }
+
+  void Clear();
+  void AddParticle(const TParticle *part);
+  void AddParticle(Int_t pdg, Double_t px, Double_t py, Double_t pz, Double_t e);
+  void EndEvent(Double_t w=1.);
+
+  unsigned int GetNEvents() const { return fWeight.size(); }
+  TEventView operator[](unsigned int iev) const { return TEventView(this, iev); }
+
+  class const_iterator {
+  public:
+    const_iterator(const TEventBatch *batch, unsigned int iev): fBatch(batch), fIev(iev) {}
+    TEventView operator*() const { return TEventView(fBatch, fIev); }
+    const_iterator& operator++() { ++fIev; return *this; }
+    bool operator!=(const const_iterator& it) const { return fIev != it.fIev; }
+  private:
+    const TEventBatch *fBatch; // iterated batch
+    unsigned int fIev; // current event
+  };
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, GetNEvents()); }
+
+private:
+
+  friend class TEventView;
+
+  std::vector<Int_t> fPdg; // PDG codes of all particles in the batch
+  std::vector<Double_t> fPx, fPy, fPz, fE; // momenta and energies of all particles
+  std::vector<unsigned int> fFirst; // first particle of each event, last element is the end
+  std::vector<Double_t> fWeight; // weight of each event
+
+};//TEventBatch
+
+class TBatchSource {
+
+public:
+
+  virtual ~TBatchSource() {}
+
+  //generate up to nev events to the batch, the batch is cleared first,
+  //returns the number of events, less than nev at the end of input
+  virtual unsigned int FillBatch(TEventBatch& batch, unsigned int nev) = 0;
+
+};//TBatchSource
+
+//_____________________________________________________________________________
+unsigned int TEventView::GetNParticles() const { return fBatch->fFirst[fIev+1] - fBatch->fFirst[fIev]; }
+Int_t TEventView::Pdg(unsigned int i) const { return fBatch->fPdg[ fBatch->fFirst[fIev] + i ]; }
+Double_t TEventView::Px(unsigned int i) const { return fBatch->fPx[ fBatch->fFirst[fIev] + i ]; }
+Double_t TEventView::Py(unsigned int i) const { return fBatch->fPy[ fBatch->fFirst[fIev] + i ]; }
+Double_t TEventView::Pz(unsigned int i) const { return fBatch->fPz[ fBatch->fFirst[fIev] + i ]; }
+Double_t TEventView::E(unsigned int i) const { return fBatch->fE[ fBatch->fFirst[fIev] + i ]; }
+Double_t TEventView::Weight() const { return fBatch->fWeight[fIev]; }
+
+#endif
+
@@ -0,0 +1,50 @@
+#ifndef TEventStream_h
+#define TEventStream_h
+
+// pull-based stream of event batches from a generator, for use
+// in range-based loops:
+//
+//   TEventStream stream(&gen, 1000, nev);
+//   for(const TEventBatch& batch: stream) {
+//     for(TEventView ev: batch) { ... }
+//   }
+//
+// the batch is owned by the stream and refilled in place
+
+#include "TEventBatch.h"
+
+class TEventStream {
+
+public:
+
+  TEventStream(TBatchSource *src, unsigned int nbatch=1000, unsigned long nev=0);
+
+  bool Next();
+  const TEventBatch& GetBatch() const { return fBatch; }
+  unsigned long GetNEvents() const { return fNdone; }
+
+  class iterator {
+  public:
+    iterator(TEventStream *stream): fStream(stream) {}
+    const TEventBatch& operator*() const { return fStream->fBatch; }
+    iterator& operator++() { if( !fStream->Next() ) fStream = 0x0; return *this; }
+    bool operator!=(const iterator& it) const { return fStream != it.fStream; }
+  private:
+    TEventStream *fStream; // null at the end of stream
+  };
+
+  iterator begin() { return Next() ? iterator(this) : end(); }
+  iterator end() { return iterator(0x0); }
+
+private:
+
+  TBatchSource *fSrc; // generator filling the batches
+  unsigned int fNbatch; // events per batch
+  unsigned long fNevt; // maximal number of events, 0 for all from the source
+  unsigned long fNdone; // events produced so far
+  TEventBatch fBatch; // current batch
+
+};//TEventStream
+
+#endif
+
@@ -1,83 +1,91 @@
 #ifndef TGenPsi2S_h
 #define TGenPsi2S_h
 
+// feed-down generator on STARlight input, each input event is decayed in all
+// configured channels (TDecayChannel), by default psi(2S) -> J/psi -> mu+mu-
+
 class TPythia8Decayer;
-class TDatabasePDG;
+class TDecayPythia8;
 class TLorentzVector;
-class TClonesArray;
-class TDecayPolarized;
-class TParticle;
-class TFile;
-class TTree;
+class TCompInput;
+class TDecayChannel;
+class TInputCache;
+class TKinSampler;
+class TRandom3;
 
 #include <vector>
-#include <fstream>
+#include <string>
 #include "Rtypes.h"
+#include "TEventBatch.h"
 
-class TGenPsi2S {
+class TGenPsi2S : public TBatchSource {
 
 public:
 
+  enum EDecay {kDecayer=0, kPythia8}; // parent decays by TPythia8Decayer or directly by Pythia8
+
   TGenPsi2S(const std::string& inp, const std::string& outp, int nev);
   ~TGenPsi2S();
 
+  TDecayChannel* AddChannel(int parent, int vm, int lepton, const std::string& outp);
+  bool LoadChannels(const std::string& cfg);
+  unsigned int GetNChannels() const { return fChan.size(); }
+  TDecayChannel* GetChannel(unsigned int i) { return fChan[i]; }
+
+  //settings for all channels
   void SetEtaRange(double etamin, double etamax);
-  void EventLoop();
+  bool SetCuts(const std::string& cfg);
+  bool SetHistConfig(const std::string& cfg);
+  bool SetPolConfig(const std::string& cfg);
+  void AddPolHypothesis(double lth, double lph, double ltp);
+  void SetTxIndex(const std::string& name);
 
-private:
+  bool SetInputCache(const std::string& name="");
+  void SetDecay(EDecay decay) { fDecay = decay; }
+
+  bool FillSampler(TKinSampler& smp);
+  void SetSampler(TKinSampler *smp, unsigned long nev, unsigned int stream=0);
 
-  bool PolarizedJpsi();
+  void EventLoop();
+  unsigned int FillBatch(TEventBatch& batch, unsigned int nev);
 
-  void KeepFinalOnly();
+private:
 
-  bool AcceptDecay();
-  bool AcceptParticle(int idx);
+  void ClearChannels();
+  UInt_t ChannelSeed(unsigned int ichan) const;
+  void InitDecay();
+  bool Decay(unsigned int ichan, TLorentzVector& vgen);
+  int NextEvent();
+  int NextInput(TLorentzVector& vgen);
+  bool CheckParents(const TLorentzVector& vgen);
 
   bool LoadInputEvent(TLorentzVector& vgen);
+  bool SampleInputEvent(TLorentzVector& vgen);
   void LoadParticle(TLorentzVector& pvec, const std::string& line);
 
-  void WriteStarlight();
-  void PutTxTrack(std::ostringstream &tx, unsigned int ipart);
-
-  std::ifstream fInp; // input file
+  std::string fInpName; // name of the input file
+  TCompInput *fInp; // input file, plain or compressed
   unsigned long fNevt; // number of events to process
+  unsigned long fNinp; // number of loaded input events
+  unsigned long fNreject; // number of rejected broken input events
+  bool fParentChecked; // channel parents compared with the input mass
 
-  std::ofstream fTxOut; //output in Starlight .tx format
-  std::string fEvtline; // event line
-  std::string fVtxline; // vertex line
-  unsigned long fNtx; //output events to Starlight .tx format
+  TInputCache *fCache; // binary cache of input events
+  bool fCacheRead; // input events are read from the cache
 
-  TDatabasePDG *fPdgDat; // PDG database
-  TPythia8Decayer *fDec; // Pythia8 decayer
-  TClonesArray *fPart; // clones array for decay products
-  TDecayPolarized *fPol; // polarized J/psi decayer
+  TKinSampler *fSampler; // parents generated in memory instead of input file
+  TRandom3 *fSmpRnd; // random stream of the sampler
+  unsigned long fSmpNev; // number of parents to generate
+  std::vector<Double_t> fSmpBlock; // block of generated parents, px, py, pz, E
+  unsigned int fSmpPos; // next parent in the block
+  unsigned int fStream; // random stream for the sampler and all decays
 
-  std::vector<const TParticle*> fVecPol; // all psi(2S) decay products with J/psi polarized decay
+  EDecay fDecay; // selected decay backend
+  TPythia8Decayer *fDec; // Pythia8 decayer shared by all channels
+  TDecayPythia8 *fDec8; // direct Pythia8 decays shared by all channels
 
-  bool fUseEta; // flag to use eta interval
-  double fEtaMin; // minimal pseudorapidity
-  double fEtaMax; // maximal pseudorapidity
-
-  TFile *fRootOut; // output ROOT file
-  TTree *jGenTree; // output tree with J/psi kinematics
-  Double_t jGenPt, jGenPt2; // pT and pT^2
-  Double_t jGenY; // rapidity
-  Double_t jGenPhi; // azimuthal angle
+  std::vector<TDecayChannel*> fChan; // decay channels fed from the input
 
 };//TGenPsi2S
 
 #endif
-
-
-
-
-
-
-
-
-
-
-
-
-
-
@@ -2,22 +2,38 @@
 #define TGenUPCJpsiFlat_h
 
 #include "TGenerator.h"
+#include "TEventBatch.h"
 
-#include <fstream>
+#include <string>
 
 class TRandom3;
 class TDecayPolarized;
-class TDatabasePDG;
+class TCompOutput;
+class TTxIndex;
+class TAccMap;
+class TCutEngine;
 
-class TGenUPCJpsiFlat : public TGenerator {
+class TGenUPCJpsiFlat : public TGenerator, public TBatchSource {
 
 public:
 
-  TGenUPCJpsiFlat(Double_t pt2max, Double_t etamin, Double_t etamax);
+  static const Int_t kLeptonPdg = 11; // daughters of the polarized J/psi decay
+
+  TGenUPCJpsiFlat(Double_t pt2max, Double_t etamin, Double_t etamax, const std::string& txout="output.tx");
   ~TGenUPCJpsiFlat();
 
+  void SetSeed(UInt_t seed);
+  void SetAcceptanceMap(const TAccMap *map) { fAccMap = map; }
+  bool SetCuts(const std::string& cfg);
+  void PrintCuts() const;
+  bool SetTxIndex(const std::string& name);
+
+  Bool_t GenerateTrial();
   void GenerateEvent();
+  Double_t GetWeight() const { return fWeight; }
   Int_t ImportParticles(TClonesArray *particles, Option_t *opt=0x0);
+  unsigned int FillBatch(TEventBatch& batch, unsigned int nev);
+  const TParticle* GetParticle(Int_t idx) const { return fPart[idx]; }
   void WriteStarlight();
 
 
@@ -31,17 +47,21 @@ private:
   Double_t fPhiMin, fPhiRange; // azimuthal angle minimum and range
   Double_t fMass; // PDG J/psi mass
 
-  TDatabasePDG *fPdgDat;
-
   TRandom3 *fRand; // random generator
 
   TDecayPolarized *fDec; // implements polarized J/psi decays
   std::vector<const TParticle*> fPart; // storage for pointers to decayed particles
 
-  std::ofstream fTxOut; //output in Starlight .tx format
+  const TAccMap *fAccMap; // acceptance for weighted mode, not owned
+  Double_t fWeight; // weight of the current event
+
+  TCutEngine *fCuts; // configured selection in addition to the eta range
+
+  TCompOutput *fTxOut; //output in Starlight .tx format, plain or compressed
   std::string evtline[2]; // event line
   std::string vtxline; // vertex line
   unsigned long fNtx; //output events to Starlight .tx format
+  TTxIndex *fTxIdx; // event index for .tx output
 
 };//TGenUPCJpsiFlat
 
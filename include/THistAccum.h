@@ -0,0 +1,59 @@
+#ifndef THistAccum_h
+#define THistAccum_h
+
+// in-memory accumulation of pre-booked 1D/2D/3D histograms,
+// each thread fills its own slot of plain bin arrays, the slots
+// are merged to TH1D/TH2D/TH3D at the end
+
+#include <vector>
+#include <string>
+#include "Rtypes.h"
+
+class THistAccum {
+
+public:
+
+  THistAccum(const std::vector<std::string>& vars);
+
+  bool LoadConfig(const std::string& cfg);
+  bool Book(const std::string& name, const std::vector<std::string>& vars,
+    const std::vector<int>& nbins, const std::vector<double>& vmin, const std::vector<double>& vmax);
+
+  void SetNSlots(unsigned int nslot);
+  void Fill(unsigned int slot, const Double_t *val, Double_t w=1.);
+
+  void Write();
+
+  unsigned int GetNHist() const { return fHist.size(); }
+  int GetVarIndex(const std::string& var) const;
+
+private:
+
+  struct HistDef {
+    std::string name; // histogram name
+    int ndim; // dimension, 1, 2 or 3
+    int ivar[3]; // index of variable for each axis
+    int nbins[3]; // number of bins along each axis
+    double vmin[3], vmax[3]; // axis range
+    double scale[3]; // nbins/(vmax-vmin)
+    unsigned long offset; // first cell in the slot arrays
+    unsigned long ncells; // number of cells including under- and overflows
+  };
+
+  struct Slot {
+    std::vector<Double_t> sumw; // sum of weights in all cells
+    std::vector<Double_t> sumw2; // sum of squared weights in all cells
+    std::vector<unsigned long> nfill; // number of fills for each histogram
+  };
+
+  int FindBin(const HistDef& hd, int iaxis, Double_t val) const;
+
+  std::vector<std::string> fVars; // names of variables available for filling
+  std::vector<HistDef> fHist; // booked histograms
+  unsigned long fNcells; // total number of cells in all histograms
+  std::vector<Slot> fSlot; // per-thread accumulators
+
+};//THistAccum
+
+#endif
+
@@ -0,0 +1,61 @@
+#ifndef TInputCache_h
+#define TInputCache_h
+
+// binary cache of parent four-vectors parsed from STARlight input, the cache
+// is written next to the input during the first pass and memory-mapped in later
+// runs, it is valid only for the same size and modification time of the input
+
+#include <string>
+#include <cstdio>
+#include "Rtypes.h"
+
+class TLorentzVector;
+
+class TInputCache {
+
+public:
+
+  TInputCache();
+  ~TInputCache();
+
+  static std::string CacheName(const std::string& inp) { return inp + ".cache"; }
+
+  //reading
+  bool Open(const std::string& name, const std::string& inp);
+  bool Next(TLorentzVector& vgen);
+  ULong64_t GetNEvents() const { return fNevt; }
+
+  //writing
+  bool Create(const std::string& name, const std::string& inp);
+  void Add(const TLorentzVector& vgen);
+  bool Finish();
+
+private:
+
+  struct Header {
+    char tag[8]; // format tag
+    ULong64_t size; // size of the input file
+    Long64_t mtime; // modification time of the input, seconds
+    Long64_t mtime_ns; // nanoseconds of the modification time
+    ULong64_t nev; // number of cached events
+  };
+
+  static bool SourceKey(const std::string& inp, Header& hdr);
+  void Close();
+
+  //memory-mapped cache
+  void *fMap; // mapped cache file
+  size_t fMapSize; // size of the mapping
+  const Double_t *fRec; // px, py, pz and energy for each event
+  ULong64_t fNevt; // number of events
+  ULong64_t fIev; // next event to read
+
+  //cache being written
+  FILE *fOut; // output under temporary name
+  std::string fName; // final name of the cache
+  std::string fTmpName; // unique temporary name next to the cache
+  Header fHdr; // header for the written cache
+
+};//TInputCache
+
+#endif
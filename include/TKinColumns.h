@@ -0,0 +1,61 @@
+#ifndef TKinColumns_h
+#define TKinColumns_h
+
+// columnar computation of boxgen observables for a batch of decays, daughter
+// four-momenta are kept in separate arrays and each observable is computed
+// by a simd loop over the batch: pT, eta and phi of the daughters, mass, pT
+// and rapidity of the dilepton and daughter angles in the dilepton rest frame;
+// log and atan2 in the loops come from glibc libmvec (flags in CMakeLists.txt)
+
+#include <vector>
+#include <string>
+#include "Rtypes.h"
+
+class TParticle;
+
+class TKinColumns {
+
+public:
+
+  //observables in the order of output columns
+  enum EVar {kD0pT=0, kD0eta, kD0phi, kD1pT, kD1eta, kD1phi, kMrec, kPTrec, kPT2rec, kYrec,
+    kD0cosTheta, kD0phiHx, kD1cosTheta, kD1phiHx, kNvar};
+
+  TKinColumns(unsigned int nmax=4096);
+
+  static const char* GetVarName(int ivar);
+  static std::vector<std::string> GetVarNames();
+
+  void Clear() { fN = 0; }
+  bool IsFull() const { return fN >= fNmax; }
+  unsigned int GetN() const { return fN; }
+
+  void Add(const TParticle *d0, const TParticle *d1);
+  void AddPtEtaPhi(const Double_t *d0, const Double_t *d1, Double_t mass);
+
+  void Compute();
+
+  const Double_t* GetColumn(int ivar) const { return &fOut[ivar][0]; }
+  void GetRow(unsigned int i, Double_t *val) const;
+
+private:
+
+  //input daughter four-momenta and intermediate dilepton columns
+  enum ECol {kPx0=0, kPy0, kPz0, kE0, kPx1, kPy1, kPz1, kE1, kNcol};
+
+  static void PtEtaPhi(unsigned int n, const Double_t *px, const Double_t *py, const Double_t *pz,
+    Double_t *pt, Double_t *eta, Double_t *phi);
+  static void RestAngles(unsigned int n, const Double_t *px, const Double_t *py, const Double_t *pz,
+    const Double_t *e, const Double_t *bx, const Double_t *by, const Double_t *bz, const Double_t *gam,
+    Double_t *cth, Double_t *phi);
+
+  unsigned int fNmax; // batch size
+  unsigned int fN; // decays in the current batch
+
+  std::vector<Double_t> fIn[kNcol]; // daughter four-momenta
+  std::vector<Double_t> fBoost[4]; // dilepton rest frame boost vector and gamma
+  std::vector<Double_t> fOut[kNvar]; // computed observables
+
+};//TKinColumns
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef TKinSampler_h
+#define TKinSampler_h
+
+// sampler of parent kinematics in (pT, y), the 2D spectrum is filled from
+// a reference STARlight input or taken from a histogram and converted to
+// an alias table, generation is constant time per parent, uniform within
+// the selected bin and in azimuth; each random stream is independent
+
+#include <vector>
+#include <string>
+#include "Rtypes.h"
+
+class TH2;
+class TRandom3;
+
+class TKinSampler {
+
+public:
+
+  TKinSampler(Int_t npt=300, Double_t ptmin=0, Double_t ptmax=1.5, Int_t ny=120, Double_t ymin=-6, Double_t ymax=6);
+
+  void Fill(Double_t pt, Double_t y, Double_t w=1.);
+  bool FromHist(const TH2 *hx);
+  bool Build();
+
+  bool Save(const std::string& name) const;
+  bool Load(const std::string& name);
+
+  void Generate(TRandom3& rnd, Double_t mass, unsigned int n, Double_t *p4) const;
+
+  Double_t GetNFill() const { return fNfill; }
+
+private:
+
+  int fNbins[2]; // bins in pT and y
+  Double_t fMin[2], fMax[2]; // ranges in pT and y
+  Double_t fWidth[2]; // bin widths
+
+  std::vector<Double_t> fSumw; // spectrum, pT index changes fastest
+  Double_t fNfill; // sum of weights in the spectrum
+
+  std::vector<Float_t> fProb; // alias table, probability to keep the cell
+  std::vector<UInt_t> fAlias; // alias table, alternative cell
+
+};//TKinSampler
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef TPdgTable_h
+#define TPdgTable_h
+
+// embedded table of particles produced by the generators, mass, charge
+// and Geant3 code without loading ROOT's TDatabasePDG, which is consulted
+// only for codes not present in the table
+
+#include "Rtypes.h"
+
+class TPdgTable {
+
+public:
+
+  struct Entry {
+    Int_t pdg; // PDG code of the particle, antiparticle has the negative code
+    Double_t mass; // mass in GeV
+    Double_t charge; // charge of the particle in units of e
+    Int_t g3; // Geant3 code of the particle
+    Int_t g3bar; // Geant3 code of the antiparticle
+    const char *name; // name of the particle
+  };
+
+  static const Entry* Find(Int_t pdg);
+
+  static Double_t Mass(Int_t pdg);
+  static Double_t Charge(Int_t pdg);
+  static Int_t Geant3(Int_t pdg);
+
+};//TPdgTable
+
+#endif
+
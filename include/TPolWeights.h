@@ -0,0 +1,56 @@
+#ifndef TPolWeights_h
+#define TPolWeights_h
+
+// decay angles of vector meson dilepton decay in helicity or Collins-Soper frame
+// and per-event weights for a list of polarization hypotheses (lambda_theta,
+// lambda_phi, lambda_theta_phi), relative to the generated 1 + alpha*cos^2(theta)
+// in the helicity frame
+
+#include <vector>
+#include <string>
+#include "Rtypes.h"
+
+class TLorentzVector;
+
+class TPolWeights {
+
+public:
+
+  enum EFrame {kHelicity=0, kCollinsSoper};
+
+  TPolWeights(Double_t alpha=1);
+
+  void SetFrame(EFrame frame) { fFrame = frame; }
+  bool SetBeamEnergy(Double_t ebeam);
+  void AddHypothesis(Double_t lth, Double_t lph, Double_t ltp);
+  bool LoadConfig(const std::string& cfg);
+
+  void Compute(const TLorentzVector& vm, const TLorentzVector& lep);
+
+  EFrame GetFrame() const { return fFrame; }
+  Double_t GetCosTheta() const { return fCosTheta; }
+  Double_t GetPhi() const { return fPhi; }
+  unsigned int GetNHypo() const { return fLth.size(); }
+  Double_t GetLambdaTheta(unsigned int i) const { return fLth[i]; }
+  Double_t GetLambdaPhi(unsigned int i) const { return fLph[i]; }
+  Double_t GetLambdaThetaPhi(unsigned int i) const { return fLtp[i]; }
+  const Double_t* GetWeights() const { return fW.empty() ? 0x0 : &fW[0]; }
+
+  void Angles(const TLorentzVector& vm, const TLorentzVector& lep, EFrame frame,
+    Double_t& costh, Double_t& phi) const;
+
+private:
+
+  Double_t fAlpha; // generated polarization in helicity frame
+  EFrame fFrame; // frame for decay angles and hypotheses
+  Double_t fEbeam, fPbeam; // beam energy and momentum per nucleon
+
+  std::vector<Double_t> fLth, fLph, fLtp; // lambda_theta, lambda_phi and lambda_theta_phi for each hypothesis
+  std::vector<Double_t> fW; // weights for the current event
+
+  Double_t fCosTheta, fPhi; // decay angles for the current event in selected frame
+
+};//TPolWeights
+
+#endif
+
@@ -0,0 +1,47 @@
+#ifndef TTxIndex_h
+#define TTxIndex_h
+
+// sidecar index for Starlight .tx output, one record per event with the event
+// number, offset of its EVENT line in uncompressed text and dilepton y and pT,
+// used to extract event ranges and kinematic slices without reading the whole file
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "Rtypes.h"
+
+class TTxIndex {
+
+public:
+
+  struct Record {
+    ULong64_t ntx; // event number in EVENT line
+    ULong64_t offset; // offset of EVENT line in uncompressed .tx
+    Float_t y; // dilepton rapidity
+    Float_t pt; // dilepton pT
+  };
+
+  TTxIndex() {}
+  ~TTxIndex() { Close(); }
+
+  static std::string IndexName(const std::string& tx) { return tx + ".idx"; }
+
+  //writing
+  bool Create(const std::string& name);
+  void Add(ULong64_t ntx, ULong64_t offset, Double_t y, Double_t pt);
+  void Close();
+
+  //reading
+  bool Load(const std::string& name);
+  unsigned long GetN() const { return fRec.size(); }
+  const Record& At(unsigned long i) const { return fRec[i]; }
+  long Find(ULong64_t ntx) const;
+
+private:
+
+  std::ofstream fOut; // index being written
+  std::vector<Record> fRec; // loaded records, also buffer for writing
+
+};//TTxIndex
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef TValidator_h
+#define TValidator_h
+
+// binned distributions of generated events for statistical comparison
+// of a candidate generation path with the reference path, pT, y and mass
+// of the dilepton, helicity frame decay angles and multiplicity
+
+#include <vector>
+#include <string>
+#include "Rtypes.h"
+
+class TH1D;
+class TEventBatch;
+class TDirectory;
+class TPolWeights;
+
+class TValidator {
+
+public:
+
+  TValidator();
+  ~TValidator();
+
+  void Fill(const TEventBatch& batch);
+  void SetTiming(Double_t rtime, unsigned long nev) { fTime = rtime; fNevt = nev; }
+
+  void Write() const;
+  bool Load(TDirectory *dir);
+
+  static bool Compare(const TValidator& ref, const TValidator& cand, Double_t pmin);
+
+private:
+
+  void Book();
+
+  std::vector<TH1D*> fHist; // compared distributions
+  TPolWeights *fAngles; // helicity frame decay angles
+
+  Double_t fTime; // real time to generate the events
+  unsigned long fNevt; // number of generated events
+
+};//TValidator
+
+#endif
+
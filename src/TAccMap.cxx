@@ -0,0 +1,282 @@
+
+//C++ headers
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+//ROOT headers
+#include "TParticle.h"
+#include "TLorentzVector.h"
+#include "TH3D.h"
+
+//local headers
+#include "TAccMap.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+TAccMap::TAccMap(): fNtrials(0) {
+
+  //empty map, to be loaded from file
+
+  for(int i=0; i<3; i++) {
+    fNbins[i] = 0;
+    fMin[i] = 0;
+    fMax[i] = 0;
+    fScale[i] = 0;
+  }
+
+}//TAccMap
+
+//_____________________________________________________________________________
+TAccMap::TAccMap(Int_t npt2, Double_t pt2min, Double_t pt2max, Int_t ny, Double_t ymin, Double_t ymax,
+  Int_t ncth, Double_t cthmin, Double_t cthmax): fNtrials(0) {
+
+  fNbins[0] = npt2;
+  fNbins[1] = ny;
+  fNbins[2] = ncth;
+
+  fMin[0] = pt2min;
+  fMin[1] = ymin;
+  fMin[2] = cthmin;
+
+  fMax[0] = pt2max;
+  fMax[1] = ymax;
+  fMax[2] = cthmax;
+
+  for(int i=0; i<3; i++) fScale[i] = fNbins[i]/(fMax[i]-fMin[i]);
+
+  fEff.assign(fNbins[0]*fNbins[1]*fNbins[2], 0);
+
+  SetNSlots(1);
+
+}//TAccMap
+
+//_____________________________________________________________________________
+void TAccMap::Vars(const TParticle *d0, const TParticle *d1, Double_t *val) {
+
+  //map variables from the decay: pT^2 and rapidity of the dilepton and cos(theta)
+  //of the first daughter in dilepton rest frame, same as d0cosTheta_hx in bgen_tree
+
+  TLorentzVector d0vec, d1vec;
+  d0->Momentum(d0vec);
+  d1->Momentum(d1vec);
+
+  TLorentzVector vmrec = d0vec + d1vec;
+  Double_t pt = vmrec.Pt();
+
+  val[0] = pt*pt;
+  val[1] = vmrec.Rapidity();
+
+  TVector3 bvec = vmrec.BoostVector();
+  d0vec.Boost(-bvec.x(), -bvec.y(), -bvec.z());
+  val[2] = d0vec.CosTheta();
+
+}//Vars
+
+//_____________________________________________________________________________
+void TAccMap::SetNSlots(unsigned int nslot) {
+
+  //counters for nslot threads, contents are reset
+
+  fSlot.clear();
+  fSlot.resize(nslot);
+
+  for(unsigned int i=0; i<nslot; i++) {
+    fSlot[i].ngen.assign(fEff.size(), 0);
+    fSlot[i].nacc.assign(fEff.size(), 0);
+  }
+
+}//SetNSlots
+
+//_____________________________________________________________________________
+int TAccMap::FindBin(int iaxis, Double_t val) const {
+
+  //bin index from 0, -1 outside the range
+
+  if( val < fMin[iaxis] or val >= fMax[iaxis] ) return -1;
+
+  int ibin = int( (val - fMin[iaxis])*fScale[iaxis] );
+  if( ibin >= fNbins[iaxis] ) ibin = fNbins[iaxis] - 1;
+
+  return ibin;
+
+}//FindBin
+
+//_____________________________________________________________________________
+void TAccMap::Fill(unsigned int slot, const Double_t *val, bool accepted) {
+
+  //one generated decay in a given slot, val from Vars
+
+  int i0 = FindBin(0, val[0]);
+  int i1 = FindBin(1, val[1]);
+  int i2 = FindBin(2, val[2]);
+
+  if( i0 < 0 or i1 < 0 or i2 < 0 ) return;
+
+  unsigned long icell = Cell(i0, i1, i2);
+
+  fSlot[slot].ngen[icell]++;
+  if( accepted ) fSlot[slot].nacc[icell]++;
+
+}//Fill
+
+//_____________________________________________________________________________
+void TAccMap::Merge() {
+
+  //acceptance from counters summed over all slots
+
+  fNtrials = 0;
+
+  for(unsigned long icell=0; icell<fEff.size(); icell++) {
+
+    unsigned long long ngen = 0, nacc = 0;
+    for(unsigned int is=0; is<fSlot.size(); is++) {
+      ngen += fSlot[is].ngen[icell];
+      nacc += fSlot[is].nacc[icell];
+    }
+
+    fEff[icell] = ngen > 0 ? Double_t(nacc)/ngen : 0;
+    fNtrials += ngen;
+  }
+
+}//Merge
+
+//_____________________________________________________________________________
+bool TAccMap::Save(const string& name) const {
+
+  //binary map: tag, bins and ranges, number of trials, acceptance as float
+
+  ofstream out(name.c_str(), ios::binary);
+  if( !out.is_open() ) {
+    cout << "TAccMap: can not write " << name << endl;
+    return false;
+  }
+
+  out.write("TACCMAP1", 8);
+  out.write(reinterpret_cast<const char*>(fNbins), sizeof(fNbins));
+  out.write(reinterpret_cast<const char*>(fMin), sizeof(fMin));
+  out.write(reinterpret_cast<const char*>(fMax), sizeof(fMax));
+  out.write(reinterpret_cast<const char*>(&fNtrials), sizeof(fNtrials));
+  out.write(reinterpret_cast<const char*>(&fEff[0]), fEff.size()*sizeof(Float_t));
+
+  return out.good();
+
+}//Save
+
+//_____________________________________________________________________________
+bool TAccMap::Load(const string& name) {
+
+  ifstream in(name.c_str(), ios::binary);
+  if( !in.is_open() ) {
+    cout << "TAccMap: can not open " << name << endl;
+    return false;
+  }
+
+  char tag[8];
+  in.read(tag, 8);
+  if( !in.good() or memcmp(tag, "TACCMAP1", 8) != 0 ) {
+    cout << "TAccMap: " << name << " is not an acceptance map" << endl;
+    return false;
+  }
+
+  in.read(reinterpret_cast<char*>(fNbins), sizeof(fNbins));
+  in.read(reinterpret_cast<char*>(fMin), sizeof(fMin));
+  in.read(reinterpret_cast<char*>(fMax), sizeof(fMax));
+  in.read(reinterpret_cast<char*>(&fNtrials), sizeof(fNtrials));
+
+  //binning is checked before the allocation, limit of 2^28 cells
+  unsigned long ncell = 1;
+  for(int i=0; i<3; i++) {
+    if( !in.good() or fNbins[i] < 1 or !(fMax[i] > fMin[i]) or ncell*fNbins[i] > (1ul<<28) ) {
+      cout << "TAccMap: " << name << " has invalid binning" << endl;
+      return false;
+    }
+    ncell *= fNbins[i];
+  }
+
+  for(int i=0; i<3; i++) fScale[i] = fNbins[i]/(fMax[i]-fMin[i]);
+
+  fEff.resize(ncell);
+  in.read(reinterpret_cast<char*>(&fEff[0]), fEff.size()*sizeof(Float_t));
+
+  if( !in.good() ) {
+    cout << "TAccMap: " << name << " is truncated" << endl;
+    return false;
+  }
+
+  fSlot.clear();
+
+  return true;
+
+}//Load
+
+//_____________________________________________________________________________
+void TAccMap::Write(const char *name) const {
+
+  //acceptance as TH3D in the current ROOT directory
+
+  TH3D hx(name, "acceptance;p_{T}^{2};y;cos#theta", fNbins[0], fMin[0], fMax[0],
+    fNbins[1], fMin[1], fMax[1], fNbins[2], fMin[2], fMax[2]);
+
+  for(int i2=0; i2<fNbins[2]; i2++) {
+    for(int i1=0; i1<fNbins[1]; i1++) {
+      for(int i0=0; i0<fNbins[0]; i0++) {
+        hx.SetBinContent(hx.GetBin(i0+1, i1+1, i2+1), fEff[Cell(i0, i1, i2)]);
+      }
+    }
+  }
+
+  hx.Write();
+
+}//Write
+
+//_____________________________________________________________________________
+Double_t TAccMap::Eval(Double_t pt2, Double_t y, Double_t cth) const {
+
+  //trilinear interpolation between bin centers, zero outside the map
+
+  Double_t val[3] = {pt2, y, cth};
+
+  int ilo[3]; // lower bin for interpolation
+  Double_t frac[3]; // distance from the lower bin center
+
+  for(int i=0; i<3; i++) {
+
+    if( val[i] < fMin[i] or val[i] > fMax[i] ) return 0;
+
+    //position in units of bins relative to the first bin center
+    Double_t pos = (val[i] - fMin[i])*fScale[i] - 0.5;
+
+    //constant at the edges, half bin from the boundary
+    if( pos < 0 ) pos = 0;
+    if( pos > fNbins[i] - 1 ) pos = fNbins[i] - 1;
+
+    ilo[i] = int(pos);
+    if( ilo[i] > fNbins[i] - 2 ) ilo[i] = fNbins[i] - 2;
+    if( ilo[i] < 0 ) ilo[i] = 0;
+
+    frac[i] = fNbins[i] > 1 ? pos - ilo[i] : 0;
+  }
+
+  Double_t eff = 0;
+  for(int icorner=0; icorner<8; icorner++) {
+
+    int idx[3];
+    Double_t w = 1;
+    for(int i=0; i<3; i++) {
+      int up = (icorner >> i) & 1;
+      idx[i] = ilo[i] + up;
+      if( idx[i] >= fNbins[i] ) idx[i] = fNbins[i] - 1;
+      w *= up ? frac[i] : 1. - frac[i];
+    }
+
+    if( w == 0 ) continue;
+
+    eff += w*fEff[ Cell(idx[0], idx[1], idx[2]) ];
+  }
+
+  return eff;
+
+}//Eval
+
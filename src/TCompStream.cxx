@@ -0,0 +1,465 @@
+
+//C++ headers
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+
+//compression headers
+#include <zlib.h>
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
+
+//local headers
+#include "TCompStream.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+TCompStream::EMode TCompStream::ModeFromName(const string& name) {
+
+  //compression by file extension
+
+  string suffix;
+  StripSuffix(name, suffix);
+
+  if( suffix == ".gz" ) return kGzip;
+  if( suffix == ".zst" ) return kZstd;
+
+  return kPlain;
+
+}//ModeFromName
+
+//_____________________________________________________________________________
+string TCompStream::StripSuffix(const string& name, string& suffix) {
+
+  //remove compression suffix from the name, the suffix is returned separately
+
+  const char *known[] = {".gz", ".zst"};
+
+  for(unsigned int i=0; i<2; i++) {
+    string sfx(known[i]);
+    if( name.size() > sfx.size() and name.compare(name.size()-sfx.size(), sfx.size(), sfx) == 0 ) {
+      suffix = sfx;
+      return name.substr(0, name.size()-sfx.size());
+    }
+  }
+
+  suffix = "";
+
+  return name;
+
+}//StripSuffix
+
+//_____________________________________________________________________________
+TCompInput::TCompInput(const string& name): fOpen(false), fEof(false), fBad(false), fFile(0x0), fGz(0x0),
+  fZctx(0x0), fZpos(0), fZend(0), fZhint(0), fPos(0), fEnd(0), fBufStart(0) {
+
+  fMode = TCompStream::ModeFromName(name);
+
+  fBuf.resize(1<<20);
+
+  if( fMode == TCompStream::kGzip ) {
+
+    fGz = gzopen(name.c_str(), "rb");
+    if( !fGz ) return;
+    gzbuffer(fGz, 1<<18);
+
+  } else if( fMode == TCompStream::kZstd ) {
+
+#ifdef WITH_ZSTD
+    fFile = fopen(name.c_str(), "rb");
+    if( !fFile ) return;
+    fZctx = ZSTD_createDCtx();
+    fZbuf.resize( ZSTD_DStreamInSize() );
+#else
+    cout << "Error in TCompInput, compiled without zstd support (" << name << ")" << endl;
+    exit(1);
+#endif
+
+  } else {
+
+    fFile = fopen(name.c_str(), "rb");
+    if( !fFile ) return;
+  }
+
+  fOpen = true;
+
+}//TCompInput
+
+//_____________________________________________________________________________
+TCompInput::~TCompInput() {
+
+  Close();
+
+}//~TCompInput
+
+//_____________________________________________________________________________
+void TCompInput::Close() {
+
+  if( fGz ) gzclose(fGz);
+  if( fFile ) fclose(fFile);
+
+#ifdef WITH_ZSTD
+  if( fZctx ) ZSTD_freeDCtx(fZctx);
+#endif
+
+  fGz = 0x0;
+  fFile = 0x0;
+  fZctx = 0x0;
+
+  fOpen = false;
+
+}//Close
+
+//_____________________________________________________________________________
+bool TCompInput::GetLine(string& line) {
+
+  //next line without the newline character, false at the end of input
+
+  line.clear();
+
+  if( !fOpen ) return false;
+
+  while(true) {
+
+    //look for the end of line in the available text
+    char *beg = &fBuf[0] + fPos;
+    char *nl = static_cast<char*>( memchr(beg, '\n', fEnd-fPos) );
+
+    if( nl ) {
+      line.append(beg, nl-beg);
+      fPos += (nl-beg) + 1;
+      return true;
+    }
+
+    //incomplete line, keep it and read more
+    line.append(beg, fEnd-fPos);
+    fPos = fEnd;
+
+    if( !Fill() ) break;
+  }
+
+  //last line without the newline
+  return !line.empty();
+
+}//GetLine
+
+//_____________________________________________________________________________
+bool TCompInput::Seek(unsigned long long off) {
+
+  //move to offset in decompressed text; only plain input seeks directly, gzip input
+  //is decompressed from the current position up to the offset and a backward move
+  //restarts from the start of the file, zstd input can only move forward
+
+  if( !fOpen ) return false;
+
+  //already there, consecutive reads
+  if( off == Tell() ) return true;
+
+  //offset in the current block
+  if( off >= fBufStart and off < fBufStart + fEnd ) {
+    fPos = off - fBufStart;
+    return true;
+  }
+
+  if( fMode == TCompStream::kZstd ) {
+
+    if( off < fBufStart ) {
+      cout << "Error in TCompInput, backward seek in zstd input" << endl;
+      return false;
+    }
+
+    //read forward until the offset is in the current block
+    while( off >= fBufStart + fEnd ) {
+      fPos = fEnd;
+      if( !Fill() ) return false;
+    }
+    fPos = off - fBufStart;
+
+    return true;
+  }
+
+  if( fMode == TCompStream::kGzip ) {
+    if( gzseek(fGz, off, SEEK_SET) < 0 ) return false;
+  } else {
+    if( fseeko(fFile, off, SEEK_SET) != 0 ) return false;
+  }
+
+  fBufStart = off;
+  fPos = 0;
+  fEnd = 0;
+  fEof = false;
+
+  return true;
+
+}//Seek
+
+//_____________________________________________________________________________
+bool TCompInput::Fill() {
+
+  //read next block of decompressed text, false when nothing is left
+
+  if( fEof ) return false;
+
+  fBufStart += fEnd;
+  fPos = 0;
+  fEnd = ReadRaw(&fBuf[0], fBuf.size());
+
+  if( fEnd == 0 ) fEof = true;
+
+  return !fEof;
+
+}//Fill
+
+//_____________________________________________________________________________
+size_t TCompInput::ReadRaw(char *buf, size_t len) {
+
+  //decompressed bytes from the input, errors and truncated compressed input
+  //mark the input as bad
+
+  if( fMode == TCompStream::kGzip ) {
+    int nread = gzread(fGz, buf, len);
+    if( nread <= 0 ) {
+      int err;
+      gzerror(fGz, &err);
+      if( nread < 0 or err != Z_OK ) fBad = true;
+      return 0;
+    }
+    return nread;
+  }
+
+#ifdef WITH_ZSTD
+  if( fMode == TCompStream::kZstd ) {
+
+    ZSTD_outBuffer out = {buf, len, 0};
+
+    while( out.pos == 0 ) {
+
+      //compressed input exhausted
+      if( fZpos >= fZend ) {
+        fZend = fread(&fZbuf[0], 1, fZbuf.size(), fFile);
+        fZpos = 0;
+      }
+
+      //at the end of file the decoder is called with empty input to flush
+      //the data it still holds
+      ZSTD_inBuffer in = {&fZbuf[0], fZend, fZpos};
+      size_t ret = ZSTD_decompressStream(fZctx, &out, &in);
+      fZpos = in.pos;
+
+      if( ZSTD_isError(ret) ) {
+        cout << "Error in TCompInput, " << ZSTD_getErrorName(ret) << endl;
+        fBad = true;
+        return 0;
+      }
+      //empty call without output only asks for the next frame
+      if( fZend > 0 or out.pos > 0 ) fZhint = ret;
+
+      //nothing more from the file nor from the decoder
+      if( fZend == 0 and out.pos == 0 ) {
+        //end of file inside a frame
+        if( fZhint != 0 or ferror(fFile) ) fBad = true;
+        break;
+      }
+    }
+
+    return out.pos;
+  }
+#endif
+
+  size_t nread = fread(buf, 1, len, fFile);
+  if( nread == 0 and ferror(fFile) ) fBad = true;
+
+  return nread;
+
+}//ReadRaw
+
+//_____________________________________________________________________________
+TCompOutput::TCompOutput(const string& name, size_t chunk, size_t nqueue): fOpen(false), fBad(false), fFile(0x0),
+  fGz(0x0), fZctx(0x0), fChunkSize(chunk), fNbytes(0), fMaxQueue(nqueue), fDone(false) {
+
+  fMode = TCompStream::ModeFromName(name);
+
+  if( fMode == TCompStream::kGzip ) {
+
+    fGz = gzopen(name.c_str(), "wb6");
+    if( !fGz ) return;
+    gzbuffer(fGz, 1<<18);
+
+  } else if( fMode == TCompStream::kZstd ) {
+
+#ifdef WITH_ZSTD
+    fFile = fopen(name.c_str(), "wb");
+    if( !fFile ) return;
+    fZctx = ZSTD_createCCtx();
+    ZSTD_CCtx_setParameter(fZctx, ZSTD_c_compressionLevel, 3);
+    fZbuf.resize( ZSTD_CStreamOutSize() );
+#else
+    cout << "Error in TCompOutput, compiled without zstd support (" << name << ")" << endl;
+    exit(1);
+#endif
+
+  } else {
+
+    fFile = fopen(name.c_str(), "wb");
+    if( !fFile ) return;
+  }
+
+  fOpen = true;
+
+  fChunk.reserve(fChunkSize + (fChunkSize>>4));
+
+  //compression and writing in background
+  fThread = thread(&TCompOutput::WriterLoop, this);
+
+}//TCompOutput
+
+//_____________________________________________________________________________
+TCompOutput::~TCompOutput() {
+
+  Close();
+
+}//~TCompOutput
+
+//_____________________________________________________________________________
+void TCompOutput::Write(const string& str) {
+
+  //append to the current chunk, full chunk goes to the writer thread
+
+  if( !fOpen ) return;
+
+  fChunk.append(str);
+  fNbytes += str.size();
+
+  if( fChunk.size() >= fChunkSize ) Push();
+
+}//Write
+
+//_____________________________________________________________________________
+void TCompOutput::Push() {
+
+  //hand over the current chunk to the writer thread
+
+  unique_lock<mutex> lock(fMtx);
+  fCondPush.wait(lock, [this]{ return fQueue.size() < fMaxQueue; });
+
+  fQueue.push_back( string() );
+  fQueue.back().swap(fChunk);
+
+  lock.unlock();
+  fCondPop.notify_one();
+
+  fChunk.reserve(fChunkSize + (fChunkSize>>4));
+
+}//Push
+
+//_____________________________________________________________________________
+bool TCompOutput::Close() {
+
+  //flush remaining output and stop the writer thread, false when
+  //any write failed and the output is incomplete
+
+  if( !fOpen ) return !fBad;
+
+  if( !fChunk.empty() ) Push();
+
+  {
+    lock_guard<mutex> lock(fMtx);
+    fDone = true;
+  }
+  fCondPop.notify_one();
+
+  fThread.join();
+
+  if( fGz and gzclose(fGz) != Z_OK ) fBad = true;
+  if( fFile and fclose(fFile) != 0 ) fBad = true;
+
+#ifdef WITH_ZSTD
+  if( fZctx ) ZSTD_freeCCtx(fZctx);
+#endif
+
+  fGz = 0x0;
+  fFile = 0x0;
+  fZctx = 0x0;
+
+  fOpen = false;
+
+  return !fBad;
+
+}//Close
+
+//_____________________________________________________________________________
+void TCompOutput::WriterLoop() {
+
+  //writer thread, compress and write chunks from the queue
+
+  while(true) {
+
+    string chunk;
+    {
+      unique_lock<mutex> lock(fMtx);
+      fCondPop.wait(lock, [this]{ return !fQueue.empty() or fDone; });
+
+      if( fQueue.empty() ) break;
+
+      chunk.swap( fQueue.front() );
+      fQueue.pop_front();
+    }
+    fCondPush.notify_one();
+
+    WriteRaw(chunk.data(), chunk.size(), false);
+
+  }
+
+  //end of compressed frame
+  WriteRaw(0x0, 0, true);
+
+}//WriterLoop
+
+//_____________________________________________________________________________
+void TCompOutput::WriteRaw(const char *buf, size_t len, bool last) {
+
+  //failed write marks the output as bad, nothing more is written after it
+
+  if( fBad ) return;
+
+  if( fMode == TCompStream::kGzip ) {
+    if( len > 0 and gzwrite(fGz, buf, len) != int(len) ) fBad = true;
+    return;
+  }
+
+#ifdef WITH_ZSTD
+  if( fMode == TCompStream::kZstd ) {
+
+    ZSTD_inBuffer in = {buf, len, 0};
+    ZSTD_EndDirective mode = last ? ZSTD_e_end : ZSTD_e_continue;
+
+    while(true) {
+
+      ZSTD_outBuffer out = {&fZbuf[0], fZbuf.size(), 0};
+      size_t remain = ZSTD_compressStream2(fZctx, &out, &in, mode);
+
+      if( ZSTD_isError(remain) ) {
+        cout << "Error in TCompOutput, " << ZSTD_getErrorName(remain) << endl;
+        fBad = true;
+        return;
+      }
+
+      if( fwrite(out.dst, 1, out.pos, fFile) != out.pos ) {
+        fBad = true;
+        return;
+      }
+
+      //all input consumed, and for the last call also the frame is complete
+      if( last ? remain == 0 : in.pos == in.size ) break;
+    }
+
+    return;
+  }
+#endif
+
+  if( len > 0 and fwrite(buf, 1, len, fFile) != len ) fBad = true;
+
+}//WriteRaw
+
@@ -0,0 +1,252 @@
+
+//C++ headers
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+//ROOT headers
+#include "TParticle.h"
+#include "TLorentzVector.h"
+#include "TMath.h"
+
+//local headers
+#include "TCutEngine.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+TCutEngine::TCutEngine(): fNevt(0) {
+
+}//TCutEngine
+
+//_____________________________________________________________________________
+bool TCutEngine::LoadConfig(const string& cfg) {
+
+  //cuts from configuration file, one cut per line, lines starting with '#' are comments
+
+  ifstream in(cfg.c_str());
+  if( !in.is_open() ) {
+    cout << "TCutEngine: can not open " << cfg << endl;
+    return false;
+  }
+
+  string line;
+  while( getline(in, line) ) {
+
+    istringstream ss(line);
+    string key;
+    if( !(ss >> key) or key[0] == '#' ) continue;
+
+    if( !AddCut(line) ) return false;
+  }
+
+  return true;
+
+}//LoadConfig
+
+//_____________________________________________________________________________
+bool TCutEngine::AddCut(const string& line) {
+
+  //cut in the form: scope var min max [abs]
+  //
+  //  scope: lep   - both dilepton daughters (first two particles) must pass
+  //         all   - all particles must pass
+  //         any   - at least one particle must pass
+  //         pair  - dilepton system
+  //         event - sum of all particles
+  //
+  //  var: eta, pt, y, m, phi, pdg (pdg only for particle scopes)
+  //
+  //example: 'pair y 1.45 2.45 abs' or 'lep pdg 13 13 abs'
+
+  istringstream ss(line);
+
+  string scope, var, opt;
+  Cut cut;
+  cut.abs = false;
+  cut.text = line;
+
+  if( !(ss >> scope >> var >> cut.vmin >> cut.vmax) ) {
+    cout << "TCutEngine: invalid cut: " << line << endl;
+    return false;
+  }
+  if( ss >> opt ) {
+    if( opt != "abs" ) {
+      cout << "TCutEngine: unknown option " << opt << " in: " << line << endl;
+      return false;
+    }
+    cut.abs = true;
+  }
+
+  if( scope == "lep" ) cut.scope = kLep;
+  else if( scope == "all" ) cut.scope = kAll;
+  else if( scope == "any" ) cut.scope = kAny;
+  else if( scope == "pair" ) cut.scope = kPair;
+  else if( scope == "event" ) cut.scope = kEvent;
+  else {
+    cout << "TCutEngine: unknown scope " << scope << " in: " << line << endl;
+    return false;
+  }
+
+  if( var == "eta" ) cut.var = kEta;
+  else if( var == "pt" ) cut.var = kPt;
+  else if( var == "y" ) cut.var = kY;
+  else if( var == "m" ) cut.var = kMass;
+  else if( var == "pdg" ) cut.var = kPdg;
+  else if( var == "phi" ) cut.var = kPhi;
+  else {
+    cout << "TCutEngine: unknown variable " << var << " in: " << line << endl;
+    return false;
+  }
+
+  if( cut.var == kPdg and (cut.scope == kPair or cut.scope == kEvent) ) {
+    cout << "TCutEngine: pdg only for particles in: " << line << endl;
+    return false;
+  }
+
+  fCuts.push_back(cut);
+  fNpass.push_back(0);
+
+  return true;
+
+}//AddCut
+
+//_____________________________________________________________________________
+bool TCutEngine::Accept(const vector<const TParticle*>& part) {
+
+  //evaluate the cuts in order, the first two particles are the dilepton daughters
+
+  ++fNevt;
+
+  TLorentzVector vpair, vevt;
+  bool has_pair = false, has_evt = false;
+
+  for(unsigned int icut=0; icut<fCuts.size(); icut++) {
+
+    const Cut& cut = fCuts[icut];
+    bool pass = true;
+
+    switch( cut.scope ) {
+
+      case kLep:
+        for(unsigned int i=0; i<2 and i<part.size(); i++) {
+          if( !Pass(cut, Value(cut.var, part[i])) ) { pass = false; break; }
+        }
+        break;
+
+      case kAll:
+        for(unsigned int i=0; i<part.size(); i++) {
+          if( !Pass(cut, Value(cut.var, part[i])) ) { pass = false; break; }
+        }
+        break;
+
+      case kAny:
+        pass = false;
+        for(unsigned int i=0; i<part.size(); i++) {
+          if( Pass(cut, Value(cut.var, part[i])) ) { pass = true; break; }
+        }
+        break;
+
+      case kPair:
+        if( !has_pair ) {
+          //dilepton system is made once per event
+          TLorentzVector v1;
+          for(unsigned int i=0; i<2 and i<part.size(); i++) {
+            part[i]->Momentum(v1);
+            vpair += v1;
+          }
+          has_pair = true;
+        }
+        pass = Pass(cut, Value(cut.var, vpair));
+        break;
+
+      case kEvent:
+        if( !has_evt ) {
+          TLorentzVector v1;
+          for(unsigned int i=0; i<part.size(); i++) {
+            part[i]->Momentum(v1);
+            vevt += v1;
+          }
+          has_evt = true;
+        }
+        pass = Pass(cut, Value(cut.var, vevt));
+        break;
+    }
+
+    if( !pass ) return false;
+
+    fNpass[icut]++;
+  }
+
+  return true;
+
+}//Accept
+
+//_____________________________________________________________________________
+bool TCutEngine::Pass(const Cut& cut, Double_t val) const {
+
+  if( cut.abs ) val = TMath::Abs(val);
+
+  return val >= cut.vmin and val <= cut.vmax;
+
+}//Pass
+
+//_____________________________________________________________________________
+Double_t TCutEngine::Value(EVar var, const TParticle *part) const {
+
+  switch( var ) {
+    case kEta: return part->Eta();
+    case kPt: return part->Pt();
+    case kY: return part->Y();
+    case kMass: return part->GetCalcMass();
+    case kPdg: return part->GetPdgCode();
+    case kPhi: return part->Phi();
+  }
+
+  return 0;
+
+}//Value
+
+//_____________________________________________________________________________
+Double_t TCutEngine::Value(EVar var, const TLorentzVector& vec) const {
+
+  switch( var ) {
+    case kEta: return vec.Eta();
+    case kPt: return vec.Pt();
+    case kY: return vec.Rapidity();
+    case kMass: return vec.M();
+    case kPhi: return vec.Phi();
+    default: break;
+  }
+
+  return 0;
+
+}//Value
+
+//_____________________________________________________________________________
+void TCutEngine::Print() const {
+
+  //cut flow, events passing each cut together with all previous cuts
+
+  cout << "TCutEngine: " << fNevt << " events evaluated" << endl;
+
+  streamsize prec = cout.precision();
+
+  unsigned long nprev = fNevt;
+  for(unsigned int icut=0; icut<fCuts.size(); icut++) {
+
+    Double_t eff = nprev > 0 ? Double_t(fNpass[icut])/nprev : 0;
+    Double_t cumul = fNevt > 0 ? Double_t(fNpass[icut])/fNevt : 0;
+
+    cout << "  " << setw(40) << left << fCuts[icut].text << right;
+    cout << setw(12) << fNpass[icut];
+    cout << fixed << setprecision(4) << setw(10) << eff << setw(10) << cumul << endl;
+    cout.unsetf(ios::fixed);
+    cout.precision(prec);
+
+    nprev = fNpass[icut];
+  }
+
+}//Print
+
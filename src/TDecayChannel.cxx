@@ -0,0 +1,492 @@
+
+//c++ headers
+#include <string>
+#include <iostream>
+#include <sstream>
+
+//ROOT headers
+#include <TPythia8Decayer.h>
+#include "TLorentzVector.h"
+#include "TClonesArray.h"
+#include "TParticle.h"
+#include "TMath.h"
+#include "TFile.h"
+#include "TTree.h"
+
+//local headers
+#include "TDecayChannel.h"
+#include "TDecayPolarized.h"
+#include "TCompStream.h"
+#include "THistAccum.h"
+#include "TPolWeights.h"
+#include "TCutEngine.h"
+#include "TPdgTable.h"
+#include "TTxIndex.h"
+#include "TDecayPythia8.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+TDecayChannel::TDecayChannel(int parent, int vm, int lepton, const string& outp): fParent(parent), fVm(vm),
+  fLepton(lepton), fNdecay(0), fNfail(0), fNtx(1), fUseEta(false), fEtaMin(0), fEtaMax(0), fCuts(0x0),
+  jGenPt(0), jGenPt2(0), jGenY(0), jGenPhi(0), jGenCosTheta(0), jGenPhiDecay(0), fHist(0x0) {
+
+  fPart = new TClonesArray("TParticle");
+
+  fPol = new TDecayPolarized(fLepton, 1.);
+  fPolW = new TPolWeights( fPol->GetAlpha() );
+
+  //compression suffix of output name applies to the .tx, test.gz -> test.tx.gz
+  fOutName = TCompStream::StripSuffix(outp, fOutComp);
+  fEvtline = "EVENT: ";
+  fVtxline = "VERTEX: 0 0 0 0 1 0 0 ";
+
+  //outputs are opened at the start of event loop
+  fTxOut = 0x0;
+  fTxIdx = 0x0;
+  fRootOut = 0x0;
+  jGenTree = 0x0;
+
+}//TDecayChannel
+
+//_____________________________________________________________________________
+TDecayChannel::~TDecayChannel() {
+
+  if( fRootOut ) {
+    fRootOut->cd();
+    if( fHist ) fHist->Write();
+    if( jGenTree ) jGenTree->Write();
+    fRootOut->Close();
+    delete fRootOut;
+  }
+
+  if( fTxOut ) {
+    if( !fTxOut->Close() ) cout << "TDecayChannel: write error, " << GetTxName() << " is incomplete" << endl;
+    delete fTxOut;
+  }
+  delete fTxIdx;
+
+  fPart->Clear();
+  delete fPart;
+
+  delete fPol;
+  delete fPolW;
+
+  delete fHist;
+  delete fCuts;
+
+}//~TDecayChannel
+
+//_____________________________________________________________________________
+void TDecayChannel::SetSeed(UInt_t seed) {
+
+  //polarized decays of the channel, distinct seeds for channels fed from the same input
+
+  fPol->SetSeed(seed);
+
+}//SetSeed
+
+//_____________________________________________________________________________
+void TDecayChannel::SetEtaRange(double etamin, double etamax) {
+
+  //set pseudorapidity interval for both leptons from vector meson decay
+
+  fUseEta = true;
+
+  fEtaMin = etamin;
+  fEtaMax = etamax;
+
+}//SetEtaRange
+
+//_____________________________________________________________________________
+bool TDecayChannel::SetCuts(const string& cfg) {
+
+  //selection on leptons, all decay products or the dilepton, evaluated
+  //in the event loop so that rejected events are not written
+
+  delete fCuts;
+  fCuts = new TCutEngine();
+
+  return fCuts->LoadConfig(cfg);
+
+}//SetCuts
+
+//_____________________________________________________________________________
+bool TDecayChannel::SetHistConfig(const string& cfg) {
+
+  //histogram mode, only histograms booked in cfg are written,
+  //variables are the names of jGenTree branches
+
+  vector<string> vars;
+  vars.push_back("jGenPt");
+  vars.push_back("jGenPt2");
+  vars.push_back("jGenY");
+  vars.push_back("jGenPhi");
+  vars.push_back("jGenCosTheta");
+  vars.push_back("jGenPhiDecay");
+
+  delete fHist;
+  fHist = new THistAccum(vars);
+
+  return fHist->LoadConfig(cfg);
+
+}//SetHistConfig
+
+//_____________________________________________________________________________
+bool TDecayChannel::SetPolConfig(const string& cfg) {
+
+  //frame and polarization hypotheses for per-event weights
+
+  return fPolW->LoadConfig(cfg);
+
+}//SetPolConfig
+
+//_____________________________________________________________________________
+void TDecayChannel::AddPolHypothesis(double lth, double lph, double ltp) {
+
+  fPolW->AddHypothesis(lth, lph, ltp);
+
+}//AddPolHypothesis
+
+//_____________________________________________________________________________
+void TDecayChannel::OpenOutput() {
+
+  //no file output for empty name
+  if( fOutName.empty() ) return;
+
+  fRootOut = new TFile(Form("%s.root", fOutName.c_str()), "recreate");
+
+  //histogram mode, no tree and .tx output
+  if( fHist ) return;
+
+  fTxOut = new TCompOutput( GetTxName() );
+
+  //event index along the .tx
+  if( !fIdxName.empty() ) {
+    fTxIdx = new TTxIndex();
+    if( !fTxIdx->Create(fIdxName) ) {
+      delete fTxIdx;
+      fTxIdx = 0x0;
+    }
+  }
+
+  jGenTree = new TTree("jGenTree", "jGenTree");
+  jGenTree ->Branch("jGenPt", &jGenPt, "jGenPt/D");
+  jGenTree ->Branch("jGenPt2", &jGenPt2, "jGenPt2/D");
+  jGenTree ->Branch("jGenY", &jGenY, "jGenY/D");
+  jGenTree ->Branch("jGenPhi", &jGenPhi, "jGenPhi/D");
+  jGenTree ->Branch("jGenCosTheta", &jGenCosTheta, "jGenCosTheta/D");
+  jGenTree ->Branch("jGenPhiDecay", &jGenPhiDecay, "jGenPhiDecay/D");
+
+  //weights for polarization hypotheses, listed in polHypo tree
+  unsigned int nhypo = fPolW->GetNHypo();
+  if( nhypo == 0 ) return;
+
+  jGenW.resize(nhypo);
+  jGenTree ->Branch("jGenW", &jGenW[0], Form("jGenW[%d]/D", nhypo));
+
+  Int_t frame = fPolW->GetFrame();
+  Double_t lth, lph, ltp;
+  TTree *polHypo = new TTree("polHypo", "polHypo");
+  polHypo ->Branch("frame", &frame, "frame/I");
+  polHypo ->Branch("lth", &lth, "lth/D");
+  polHypo ->Branch("lph", &lph, "lph/D");
+  polHypo ->Branch("ltp", &ltp, "ltp/D");
+  for(unsigned int i=0; i<nhypo; i++) {
+    lth = fPolW->GetLambdaTheta(i);
+    lph = fPolW->GetLambdaPhi(i);
+    ltp = fPolW->GetLambdaThetaPhi(i);
+    polHypo->Fill();
+  }
+  polHypo->Write();
+  delete polHypo;
+
+}//OpenOutput
+
+//_____________________________________________________________________________
+bool TDecayChannel::Decay(TPythia8Decayer *dec, TLorentzVector& vgen) {
+
+  //decay of the input parent with TPythia8Decayer, decay products are in fVecPol,
+  //returns true when the event passed the selection
+
+  //input vector meson is decayed directly
+  TLorentzVector vvm = vgen;
+  fOther.clear();
+
+  //parent decay to the vector meson
+  if( fVm != fParent ) {
+
+    if( !DecayParent(dec, vgen) ) {
+      ++fNfail;
+      return false;
+    }
+
+    //vector meson Lorentz vector and removal from decay clones array
+    int idx = 0;
+    for(int i=0; i<fPart->GetEntries(); i++) {
+      TParticle *part = dynamic_cast<TParticle*>( fPart->At(i) );
+
+      if( part->GetPdgCode() == fVm ) {
+        idx = i;
+        break;
+      }
+    }
+
+    TParticle *pvm = dynamic_cast<TParticle*>( fPart->At(idx) );
+    pvm->Momentum(vvm);
+    fPart->RemoveAt(idx);
+    fPart->Compress();
+
+    for(int i=0; i<fPart->GetEntries(); i++) {
+      fOther.push_back( dynamic_cast<TParticle*>( fPart->At(i) ) );
+    }
+  }
+
+  return FinishDecay(vvm);
+
+}//Decay
+
+//_____________________________________________________________________________
+bool TDecayChannel::Decay(TDecayPythia8 *dec, TLorentzVector& vgen) {
+
+  //decay of the input parent with Pythia8 used directly, the same as above
+
+  TLorentzVector vvm = vgen;
+  fOther.clear();
+
+  if( fVm != fParent ) {
+
+    //vector meson is the first of the products
+    if( !dec->Decay(fParent, fVm, vgen, fProd) ) {
+      ++fNfail;
+      return false;
+    }
+
+    fProd[0].Momentum(vvm);
+    for(unsigned int i=1; i<fProd.size(); i++) fOther.push_back( &fProd[i] );
+  }
+
+  return FinishDecay(vvm);
+
+}//Decay
+
+//_____________________________________________________________________________
+bool TDecayChannel::FinishDecay(const TLorentzVector& vvm) {
+
+  //polarized vector meson decay
+  if( !PolarizedVM(vvm) ) return false;
+
+  //configured selection before any output
+  if( fCuts and !fCuts->Accept(fVecPol) ) return false;
+
+  ++fNdecay;
+
+  return true;
+
+}//FinishDecay
+
+//_____________________________________________________________________________
+void TDecayChannel::WriteEvent() {
+
+  //vector meson kinematics in histograms
+  if( fHist ) {
+    Double_t val[6] = {jGenPt, jGenPt2, jGenY, jGenPhi, jGenCosTheta, jGenPhiDecay};
+    fHist->Fill(0, val);
+    return;
+  }
+
+  if( !fTxOut ) return;
+
+  //write the output in .tx format
+  WriteStarlight();
+
+  //write vector meson kinematics in output tree
+  jGenTree->Fill();
+
+}//WriteEvent
+
+//_____________________________________________________________________________
+void TDecayChannel::Print() const {
+
+  cout << "Channel " << fParent << " -> " << fVm << " -> " << fLepton << " " << -fLepton;
+  if( !fOutName.empty() ) cout << " (" << fOutName << ")";
+  cout << endl;
+
+  if( fCuts ) fCuts->Print();
+
+  if( fNfail > 0 ) cout << "  no " << fVm << " in parent decay: " << fNfail << endl;
+  cout << "  events written: " << fNdecay << endl;
+
+}//Print
+
+//_____________________________________________________________________________
+bool TDecayChannel::DecayParent(TPythia8Decayer *dec, TLorentzVector& vgen) {
+
+  //decay the parent until the vector meson decays to a lepton pair,
+  //false when no such decay is found in the allowed number of trials
+
+  const int ntrials = 10000;
+
+  for(int itry=0; itry<ntrials; itry++) {
+
+    fPart->Clear();
+    dec->Decay(fParent, &vgen);
+    dec->ImportParticles(fPart);
+
+    if( AcceptDecay() ) {
+      KeepFinalOnly();
+      return true;
+    }
+  }
+
+  return false;
+
+}//DecayParent
+
+//_____________________________________________________________________________
+bool TDecayChannel::PolarizedVM(const TLorentzVector& vvm) {
+
+  //polarized vector meson -> l+l- decay, other parent decay products are in fOther
+
+  //vector meson kinematics in output tree
+  jGenPt = vvm.Pt();
+  jGenPt2 = jGenPt*jGenPt;
+  jGenY = vvm.Rapidity();
+  jGenPhi = vvm.Phi();
+
+  //generate the decay
+  fPol->Generate(vvm);
+
+  //decay angles of positive lepton and weights for polarization hypotheses
+  TLorentzVector vlep;
+  fPol->GetDecay( fPol->GetDecay(0)->GetPdgCode() < 0 ? 0 : 1 )->Momentum(vlep);
+  fPolW->Compute(vvm, vlep);
+
+  jGenCosTheta = fPolW->GetCosTheta();
+  jGenPhiDecay = fPolW->GetPhi();
+  for(unsigned int i=0; i<jGenW.size(); i++) jGenW[i] = fPolW->GetWeights()[i];
+
+  //store all parent decay products including polarized vector meson
+  fVecPol.clear();
+  fVecPol.resize( fOther.size() + 2 );
+
+  fVecPol[0] = fPol->GetDecay(0);
+  fVecPol[1] = fPol->GetDecay(1);
+
+  for(unsigned int i=0; i<fOther.size(); i++) fVecPol[i+2] = fOther[i];
+
+  if( !fUseEta ) return true;
+
+  //evaluate the requested pseudorapidity interval
+
+  double eta0 = fPol->GetDecay(0)->Eta();
+  double eta1 = fPol->GetDecay(1)->Eta();
+
+  if( eta0 < fEtaMin or eta0 > fEtaMax ) return false;
+  if( eta1 < fEtaMin or eta1 > fEtaMax ) return false;
+
+  //decay passed the pseudorapidity interval
+
+  return true;
+
+}//PolarizedVM
+
+//_____________________________________________________________________________
+void TDecayChannel::KeepFinalOnly() {
+
+  //keep only vector meson and final products of parent decay, also dileptons from
+  //vector meson decay are removed since polarized decay will follow
+
+  vector<int> to_remove;
+  to_remove.reserve(fPart->GetEntries());
+
+  for(int i=0; i<fPart->GetEntries(); i++) {
+    TParticle *part = dynamic_cast<TParticle*>( fPart->At(i) );
+
+    if( part->GetPdgCode() == fVm ) {
+      to_remove.push_back( part->GetFirstDaughter() );
+      to_remove.push_back( part->GetLastDaughter() );
+      continue;
+    }
+
+    if( part->GetNDaughters() > 0 ) to_remove.push_back(i);
+  }
+
+  for(vector<int>::const_iterator it = to_remove.cbegin(); it != to_remove.cend(); ++it) {
+    fPart->RemoveAt(*it);
+  }
+
+  fPart->Compress();
+
+}//KeepFinalOnly
+
+//_____________________________________________________________________________
+bool TDecayChannel::AcceptDecay() {
+
+  //select vector meson dilepton decays
+
+  int idx0=0, idx1=0;
+  for(int i=0; i<fPart->GetEntries(); i++) {
+    TParticle *part = dynamic_cast<TParticle*>( fPart->At(i) );
+
+    if( part->GetPdgCode() == fVm ) {
+      idx0 = part->GetFirstDaughter();
+      idx1 = part->GetLastDaughter();
+      break;
+    }
+  }
+
+  if( idx0 <= 0 or idx1 <= 0 or TMath::Abs(idx1-idx0) != 1 ) return false;
+
+  if( !AcceptParticle(idx0) or !AcceptParticle(idx1) ) return false;
+
+  return true;
+
+}//AcceptDecay
+
+//_____________________________________________________________________________
+bool TDecayChannel::AcceptParticle(int idx) {
+
+  TParticle *part = dynamic_cast<TParticle*>( fPart->At(idx) );
+
+  int pdg = part->GetPdgCode();
+
+  if( TMath::Abs(pdg) != 11 and TMath::Abs(pdg) != 13 ) return false;
+
+  return true;
+
+}//AcceptParticle
+
+//_____________________________________________________________________________
+void TDecayChannel::WriteStarlight() {
+
+  //write output in Starlight .tx format
+
+  //offset of the event before it is written
+  if( fTxIdx ) fTxIdx->Add(fNtx, fTxOut->Tell(), jGenY, jGenPt);
+
+  std::ostringstream tx;
+
+  tx << fEvtline << fNtx << " " << fVecPol.size() << " 1" << endl;
+  tx << fVtxline << fVecPol.size() << endl;
+  for(unsigned int i=0; i<fVecPol.size(); i++) PutTxTrack(tx, i);
+
+  fTxOut->Write(tx.str());
+
+  ++fNtx;
+
+}//WriteStarlight
+
+//_____________________________________________________________________________
+void TDecayChannel::PutTxTrack(ostringstream &tx, unsigned int ipart) {
+
+  //utility function for Starlight .tx format
+
+  tx << "TRACK:  " << TPdgTable::Geant3( fVecPol[ipart]->GetPdgCode() ) << " ";
+  tx << fixed << fVecPol[ipart]->Px() << " ";
+  tx << fixed << fVecPol[ipart]->Py() << " ";
+  tx << fixed << fVecPol[ipart]->Pz() << " ";
+  tx << fNtx << " " << ipart << " 0 ";
+  tx << fVecPol[ipart]->GetPdgCode() << endl;
+
+}//PutTxTrack
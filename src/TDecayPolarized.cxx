@@ -3,15 +3,14 @@
 #include<vector>
 
 //ROOT headers
-#include "TF1.h"
 #include "TRandom3.h"
 #include "TParticle.h"
-#include "TParticlePDG.h"
-#include "TDatabasePDG.h"
+#include "TMath.h"
 #include "TLorentzVector.h"
 
 //local headers
 #include "TDecayPolarized.h"
+#include "TPdgTable.h"
 
 using namespace std;
 
@@ -23,29 +22,41 @@ TDecayPolarized::TDecayPolarized(Int_t pdg, Double_t alpha) {
     exit(1);
   }
 
-  fPol = new TF1("dsigdcostheta","1.+[0]*x*x",-1.,1.);
   //amount of polarization, +1: full transverse, -1: full longitudinal, 0: unpolarized
-  fPol->SetParameter(0, alpha);
+  fAlpha = alpha;
+  fPolMax = alpha > 0 ? 1.+alpha : 1.;
 
   fRand = new TRandom3();
   fRand->SetSeed(5572323);
 
-  TParticlePDG *part = TDatabasePDG::Instance()->GetParticle(pdg);
-  fMass = part->Mass();
+  fMass = TPdgTable::Mass(pdg);
   fPdg = pdg;
 
+  //charges are fixed, the random choice swaps the momenta instead, so that
+  //TParticle::SetPdgCode and its TDatabasePDG lookup run only here
   fVec.resize(2);
+  fVec[0].SetPdgCode(fPdg);
+  fVec[1].SetPdgCode(-fPdg);
 
 }//TDecayPolarized
 
 //_____________________________________________________________________________
 TDecayPolarized::~TDecayPolarized() {
 
-  delete fPol;
   delete fRand;
 
 }//~TDecayPolarized
 
+//_____________________________________________________________________________
+void TDecayPolarized::SetSeed(UInt_t seed) {
+
+  //independent random sequence, all random numbers come from fRand
+  //so that separate instances can be used in parallel threads
+
+  fRand->SetSeed(seed);
+
+}//SetSeed
+
 //_____________________________________________________________________________
 void TDecayPolarized::Generate(const TLorentzVector &vm) {
 
@@ -53,7 +64,11 @@ void TDecayPolarized::Generate(const TLorentzVector &vm) {
   Double_t e1 = vm.M() / 2.;
   Double_t p1 = TMath::Sqrt((e1 + fMass)*(e1 - fMass));
 
-  Double_t costheta = fPol->GetRandom();
+  //polar angle from 1 + alpha*cos^2(theta) by acceptance-rejection
+  Double_t costheta;
+  do {
+    costheta = 2.*fRand->Rndm() - 1.;
+  } while( fPolMax*fRand->Rndm() > 1. + fAlpha*costheta*costheta );
 
   Double_t sintheta = TMath::Sqrt((1. + costheta)*(1. - costheta));
   Double_t phi = 2. * TMath::Pi() * fRand->Rndm();
@@ -75,15 +90,12 @@ void TDecayPolarized::Generate(const TLorentzVector &vm) {
   v1.Boost(-betavmcm);
   v2.Boost(-betavmcm);
 
-  fVec[0].SetMomentum(v1);
-  fVec[1].SetMomentum(v2);
-
   if( fRand->Rndm() > 0.5 ) {
-    fVec[0].SetPdgCode(fPdg);
-    fVec[1].SetPdgCode(-fPdg);
+    fVec[0].SetMomentum(v1);
+    fVec[1].SetMomentum(v2);
   } else {
-    fVec[1].SetPdgCode(fPdg);
-    fVec[0].SetPdgCode(-fPdg);
+    fVec[0].SetMomentum(v2);
+    fVec[1].SetMomentum(v1);
   }
 
 }//Generate
@@ -0,0 +1,182 @@
+
+//C++ headers
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+#include <iostream>
+
+//Pythia8 headers
+#include "Pythia8/Pythia.h"
+
+//ROOT headers
+#include "TLorentzVector.h"
+#include "TParticle.h"
+
+//local headers
+#include "TDecayPythia8.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+TDecayPythia8::TDecayPythia8(UInt_t seed): fMaxCopies(32), fNcalls(0), fNtry(0), fNacc(0) {
+
+  //decays only, no hard process, seed 0 keeps the Pythia8 default random sequence
+
+  string xml = XmlDir();
+
+  fPythia = new Pythia8::Pythia(xml, false);
+
+  bool stat = fPythia->readString("ProcessLevel:all = off");
+  stat = stat and fPythia->readString("Print:quiet = on");
+  if( stat and seed != 0 ) {
+    stat = fPythia->readString("Random:setSeed = on");
+    stat = stat and fPythia->readString( "Random:seed = " + to_string(seed) );
+  }
+
+  //no decays are possible without the particle data
+  if( !stat or !fPythia->init() ) {
+    cout << "Error in TDecayPythia8, Pythia8 initialization failed with xml data in " << xml << endl;
+    exit(1);
+  }
+
+}//TDecayPythia8
+
+//_____________________________________________________________________________
+TDecayPythia8::~TDecayPythia8() {
+
+  delete fPythia;
+
+}//~TDecayPythia8
+
+//_____________________________________________________________________________
+string TDecayPythia8::XmlDir() {
+
+  //xml data from PYTHIA8DATA, or from the installation given by PYTHIA8_DIR or PYTHIA8
+  //as for the build in CMakeLists.txt
+
+  const char *data = getenv("PYTHIA8DATA");
+  if( data ) return data;
+
+  const char *env[] = {"PYTHIA8_DIR", "PYTHIA8"};
+  for(unsigned int i=0; i<2; i++) {
+    const char *dir = getenv(env[i]);
+    if( dir ) return string(dir) + "/share/Pythia8/xmldoc";
+  }
+
+  return "../share/Pythia8/xmldoc";
+
+}//XmlDir
+
+//_____________________________________________________________________________
+bool TDecayPythia8::Decay(int parent, int vm, const TLorentzVector& vgen, vector<TParticle>& prod) {
+
+  //decay the parent until a vector meson is produced, prod gets the vector meson
+  //first and then the other final products, false when not found in the allowed trials
+
+  const unsigned long ntrials = 10000;
+
+  //vector meson is kept undecayed, its polarized decay follows,
+  //both flags are restored for other channels sharing the particle data
+  Pythia8::ParticleData& pdat = fPythia->particleData;
+  bool pardecay = pdat.mayDecay(parent);
+  bool vmdecay = pdat.mayDecay(vm);
+  pdat.mayDecay(parent, true);
+  pdat.mayDecay(vm, false);
+
+  Pythia8::Event& event = fPythia->event;
+
+  vector<int> keep;
+  bool found = false;
+  unsigned long ntry = 0;
+
+  while( !found and ntry < ntrials ) {
+
+    //number of copies from the observed acceptance, about one accepted copy per call,
+    //a single copy for frequent decays like psi(2S) -> J/psi X, more for rare channels
+    int ncopy = fNacc > 0 ? int(fNtry/fNacc) : 1;
+    ncopy = max(1, min(ncopy, fMaxCopies));
+
+    event.clear();
+    for(int i=0; i<ncopy; i++) {
+      event.append(parent, 11, 0, 0, vgen.Px(), vgen.Py(), vgen.Pz(), vgen.E(), vgen.M());
+    }
+    fPythia->moreDecays();
+    fNcalls++;
+
+    //parents are the first entries, the first copy with the vector meson is used
+    for(int i=0; i<ncopy; i++) {
+
+      fNtry++;
+      ntry++;
+
+      int ivm = FindVM(i, vm);
+      if( ivm < 0 ) continue;
+
+      fNacc++;
+
+      keep.clear();
+      keep.push_back(ivm);
+      Collect(i, vm, keep);
+      found = true;
+      break;
+    }
+  }
+
+  pdat.mayDecay(vm, vmdecay);
+  pdat.mayDecay(parent, pardecay);
+
+  if( !found ) return false;
+
+  //vector meson first, then the other products in the order of event record
+  sort(keep.begin()+1, keep.end());
+
+  prod.resize( keep.size() );
+  for(unsigned int i=0; i<keep.size(); i++) {
+    const Pythia8::Particle& part = event[ keep[i] ];
+    prod[i] = TParticle(part.id(), 1, -1, -1, -1, -1, part.px(), part.py(), part.pz(), part.e(), 0, 0, 0, 0);
+  }
+
+  return true;
+
+}//Decay
+
+//_____________________________________________________________________________
+int TDecayPythia8::FindVM(int idx, int vm) const {
+
+  //vector meson among the descendants of particle idx, -1 if not present
+
+  const Pythia8::Particle& part = fPythia->event[idx];
+  if( part.isFinal() ) return -1;
+
+  vector<int> dlist = part.daughterList();
+  for(unsigned int i=0; i<dlist.size(); i++) {
+    if( fPythia->event[ dlist[i] ].id() == vm ) return dlist[i];
+    int ivm = FindVM(dlist[i], vm);
+    if( ivm >= 0 ) return ivm;
+  }
+
+  return -1;
+
+}//FindVM
+
+//_____________________________________________________________________________
+void TDecayPythia8::Collect(int idx, int vm, vector<int>& keep) const {
+
+  //final descendants of particle idx, the vector meson is already kept
+
+  vector<int> dlist = fPythia->event[idx].daughterList();
+  for(unsigned int i=0; i<dlist.size(); i++) {
+
+    const Pythia8::Particle& part = fPythia->event[ dlist[i] ];
+
+    if( part.id() == vm ) continue;
+
+    if( part.isFinal() ) {
+      keep.push_back( dlist[i] );
+      continue;
+    }
+
+    Collect(dlist[i], vm, keep);
+  }
+
+}//Collect
@@ -0,0 +1,54 @@
+
+//ROOT headers
+#include "TParticle.h"
+
+//local headers
+#include "TEventBatch.h"
+
+//_____________________________________________________________________________
+void TEventBatch::Clear() {
+
+  //remove all events, allocated memory is kept for the next batch
+
+  fPdg.clear();
+  fPx.clear();
+  fPy.clear();
+  fPz.clear();
+  fE.clear();
+  fWeight.clear();
+
+  fFirst.clear();
+  fFirst.push_back(0);
+
+}//Clear
+
+//_____________________________________________________________________________
+void TEventBatch::AddParticle(const TParticle *part) {
+
+  AddParticle(part->GetPdgCode(), part->Px(), part->Py(), part->Pz(), part->Energy());
+
+}//AddParticle
+
+//_____________________________________________________________________________
+void TEventBatch::AddParticle(Int_t pdg, Double_t px, Double_t py, Double_t pz, Double_t e) {
+
+  //particle to the current event
+
+  fPdg.push_back(pdg);
+  fPx.push_back(px);
+  fPy.push_back(py);
+  fPz.push_back(pz);
+  fE.push_back(e);
+
+}//AddParticle
+
+//_____________________________________________________________________________
+void TEventBatch::EndEvent(Double_t w) {
+
+  //close the current event, particles added so far belong to it
+
+  fFirst.push_back( fPdg.size() );
+  fWeight.push_back(w);
+
+}//EndEvent
+
@@ -0,0 +1,28 @@
+
+//local headers
+#include "TEventStream.h"
+
+//_____________________________________________________________________________
+TEventStream::TEventStream(TBatchSource *src, unsigned int nbatch, unsigned long nev):
+  fSrc(src), fNbatch(nbatch), fNevt(nev), fNdone(0) {
+
+}//TEventStream
+
+//_____________________________________________________________________________
+bool TEventStream::Next() {
+
+  //fill the next batch, false when the source or requested number of events is exhausted
+
+  unsigned int nreq = fNbatch;
+  if( fNevt > 0 ) {
+    if( fNdone >= fNevt ) return false;
+    if( fNevt - fNdone < nreq ) nreq = fNevt - fNdone;
+  }
+
+  unsigned int nfill = fSrc->FillBatch(fBatch, nreq);
+  fNdone += nfill;
+
+  return nfill > 0;
+
+}//Next
+
@@ -2,387 +2,595 @@
 //c++ headers
 #include <string>
 #include <iostream>
+#include <fstream>
 #include <boost/tokenizer.hpp>
-#include <iomanip>
 #include <sstream>
 
+//Pythia8 headers
+#include "Pythia8/Pythia.h"
+
 //ROOT headers
 #include <TPythia8Decayer.h>
-#include "TDatabasePDG.h"
+#include <TPythia8.h>
 #include "TLorentzVector.h"
-#include "TClonesArray.h"
-#include "TParticle.h"
+#include "TRandom3.h"
 #include "TMath.h"
-#include "TFile.h"
-#include "TTree.h"
 
 //local headers
-#include "TDecayPolarized.h"
 #include "TGenPsi2S.h"
+#include "TDecayChannel.h"
+#include "TCompStream.h"
+#include "TPdgTable.h"
+#include "TEventBatch.h"
+#include "TInputCache.h"
+#include "TTxIndex.h"
+#include "TDecayPythia8.h"
+#include "TKinSampler.h"
 
 using namespace std;
 using namespace boost;
 
 //_____________________________________________________________________________
-TGenPsi2S::TGenPsi2S(const string& inp, const string& outp, int nev): fNevt(nev), fNtx(1),
-  fUseEta(false), fEtaMin(0), fEtaMax(0), jGenPt(0), jGenPt2(0),
-  jGenY(0), jGenPhi(0) {
-
-  fInp.open(inp);
-
-  fDec = new TPythia8Decayer();
-  fDec->Init();
+TGenPsi2S::TGenPsi2S(const string& inp, const string& outp, int nev): fInpName(inp), fNevt(nev), fNinp(0),
+  fNreject(0), fParentChecked(false), fCache(0x0), fCacheRead(false), fSampler(0x0), fSmpRnd(0x0), fSmpNev(0), fSmpPos(0), fStream(0) {
 
-  fPdgDat = TDatabasePDG::Instance();
+  fInp = new TCompInput(inp);
 
-  fPart = new TClonesArray("TParticle");
+  //decayer is created at the start of generation for the selected backend
+  fDec = 0x0;
+  fDec8 = 0x0;
+  fDecay = kDecayer;
 
-  fPol = new TDecayPolarized(13, 1.);
-
-  fTxOut.open(Form("%s.tx", outp.c_str()));
-  fEvtline = "EVENT: ";
-  fVtxline = "VERTEX: 0 0 0 0 1 0 0 ";
-
-  fRootOut = new TFile(Form("%s.root", outp.c_str()), "recreate");
-  jGenTree = new TTree("jGenTree", "jGenTree");
-  jGenTree ->Branch("jGenPt", &jGenPt, "jGenPt/D");
-  jGenTree ->Branch("jGenPt2", &jGenPt2, "jGenPt2/D");
-  jGenTree ->Branch("jGenY", &jGenY, "jGenY/D");
-  jGenTree ->Branch("jGenPhi", &jGenPhi, "jGenPhi/D");
+  //default channel, psi(2S) -> J/psi -> mu+mu-
+  AddChannel(100443, 443, 13, outp);
 
 }//TGenPsi2S
 
 //_____________________________________________________________________________
 TGenPsi2S::~TGenPsi2S() {
 
-  jGenTree->Write();
-  fRootOut->Close();
-  delete fRootOut;
+  ClearChannels();
 
-  fTxOut.close();
-  fInp.close();
+  fInp->Close();
+  delete fInp;
+  delete fCache;
+  delete fSampler;
+  delete fSmpRnd;
 
   delete fDec;
-
-  fPart->Clear();
-  delete fPart;
-
-  delete fPol;
+  delete fDec8;
 
 };//~TGenPsi2S
 
 //_____________________________________________________________________________
-void TGenPsi2S::SetEtaRange(double etamin, double etamax) {
+TDecayChannel* TGenPsi2S::AddChannel(int parent, int vm, int lepton, const string& outp) {
 
-  //set pseudorapidity interval for e+ and e- from J/psi decay
+  //parent decay to vector meson and its polarized decay to lepton pair, outp is
+  //the output name, empty for no file output; each channel has its own random
+  //sequence for the polarized decay
 
-  fUseEta = true;
+  fChan.push_back( new TDecayChannel(parent, vm, lepton, outp) );
+  fChan.back()->SetSeed( ChannelSeed(fChan.size()-1) );
 
-  fEtaMin = etamin;
-  fEtaMax = etamax;
+  return fChan.back();
 
-}//SetEtaRange
+}//AddChannel
 
 //_____________________________________________________________________________
-void TGenPsi2S::EventLoop() {
+UInt_t TGenPsi2S::ChannelSeed(unsigned int ichan) const {
 
-  unsigned long iev = 0;
-  unsigned long nprint = 5e5;
-  unsigned long nreject = 0;
+  //polarized decays in the channel, the first channel of stream 0 keeps the default seed
 
-  //input event loop
-  while(true) {
+  return 5572323 + 100*ichan + 65539*fStream;
 
-    if(iev > fNevt and fNevt != 0) break;
+}//ChannelSeed
 
-    //original psi(2S) event
-    TLorentzVector vgen;
-    if( !LoadInputEvent(vgen) ) break;
+//_____________________________________________________________________________
+bool TGenPsi2S::LoadChannels(const string& cfg) {
+
+  //channels from configuration file, replacing the default channel:
+  //
+  //  channel parent vm lepton output
+  //
+  //followed by optional settings for the channel, one per line:
+  //
+  //  eta min max
+  //  cuts cuts.cfg
+  //  pol pol.cfg
+  //  hist hist.cfg
+  //  index output.tx.idx
+  //
+  //lines starting with '#' are comments
+
+  ifstream in(cfg.c_str());
+  if( !in.is_open() ) {
+    cout << "TGenPsi2S: can not open " << cfg << endl;
+    return false;
+  }
 
-    //reject broken input events
-    if( vgen.M() < 0.1 ) {
+  ClearChannels();
+
+  string line;
+  while( getline(in, line) ) {
 
-      cout << "TGenPsi2S: rejecting input event: ";
-      cout << iev+1 << " ";
-      cout << vgen.Pt() << " " << vgen.Rapidity() << " ";
-      cout << vgen.M() << endl;
+    istringstream ss(line);
 
-      ++nreject;
+    string key;
+    if( !(ss >> key) or key[0] == '#' ) continue;
 
+    if( key == "channel" ) {
+      int parent=0, vm=0, lepton=0;
+      string outp;
+      if( !(ss >> parent >> vm >> lepton >> outp) ) {
+        cout << "TGenPsi2S: invalid channel: " << line << endl;
+        return false;
+      }
+      AddChannel(parent, vm, lepton, outp);
       continue;
     }
 
-    //decay the psi(2S)
-    while(true) {
-
-      fPart->Clear();
-      fDec->Decay(100443, &vgen);
-      fDec->ImportParticles(fPart);
+    if( fChan.empty() ) {
+      cout << "TGenPsi2S: setting before any channel: " << line << endl;
+      return false;
+    }
+    TDecayChannel *chan = fChan.back();
+
+    bool stat = true;
+    if( key == "eta" ) {
+      double etamin, etamax;
+      stat = bool(ss >> etamin >> etamax);
+      if( stat ) chan->SetEtaRange(etamin, etamax);
+    } else {
+      string val;
+      ss >> val;
+      if( key == "cuts" ) stat = chan->SetCuts(val);
+      else if( key == "pol" ) stat = chan->SetPolConfig(val);
+      else if( key == "hist" ) stat = chan->SetHistConfig(val);
+      else if( key == "index" ) chan->SetTxIndex(val);
+      else stat = false;
+    }
 
-      if( AcceptDecay() ) break;
+    if( !stat ) {
+      cout << "TGenPsi2S: invalid setting: " << line << endl;
+      return false;
     }
-    KeepFinalOnly();
+  }
+
+  if( fChan.empty() ) {
+    cout << "TGenPsi2S: no channels in " << cfg << endl;
+    return false;
+  }
 
-    //polarized J/psi decay
-    if( !PolarizedJpsi() ) continue;
+  return true;
 
-    //write the output in .tx format
-    WriteStarlight();
+}//LoadChannels
 
-    //write J/psi kinematics in output tree
-    jGenTree->Fill();
+//_____________________________________________________________________________
+bool TGenPsi2S::SetInputCache(const string& name) {
 
-    /*
-    cout.precision(4);
-    cout << vgen.Pt() << " " << vgen.Rapidity() << " " << vgen.M() << endl;
+  //parsed input events from binary cache, by default next to the input, the cache
+  //is written during this run when it is missing or the input has changed
 
-    //decayer loop
-    for(int i=0; i<fPart->GetEntries(); i++) {
+  string cname = name.empty() ? TInputCache::CacheName(fInpName) : name;
 
-      TParticle *part = dynamic_cast<TParticle*>( fPart->At(i) );
+  delete fCache;
+  fCache = new TInputCache();
 
-      cout << setw(3) << i << setw(7) << part->GetPdgCode() << setw(7) << fPdgDat->GetParticle(part->GetPdgCode())->GetName();
-      cout << setw(3) << part->GetFirstDaughter() << setw(3) << part->GetLastDaughter();
-      cout << setw(3) << part->GetNDaughters() << endl;
+  fCacheRead = fCache->Open(cname, fInpName);
+  if( fCacheRead ) {
+    cout << "TGenPsi2S: " << fCache->GetNEvents() << " input events from " << cname << endl;
+    return true;
+  }
 
-    }//decayer loop
+  return fCache->Create(cname, fInpName);
 
-    //cout << fVecPol.size() << " " << fPart->GetEntries() << endl;
-    for(vector<const TParticle*>::const_iterator it = fVecPol.cbegin(); it != fVecPol.cend(); ++it) {
-      cout << setw(5) << (*it)->GetPdgCode() << endl;
-    }
-    */
+}//SetInputCache
 
-    iev++;
+//_____________________________________________________________________________
+bool TGenPsi2S::FillSampler(TKinSampler& smp) {
 
-    if (iev != 0 and iev%nprint == 0) {
-      cout << "processed " << iev << " events" << endl;
+  //parent spectrum from the whole input, the input cache is used when set,
+  //parents outside the sampler ranges are reported as they truncate the spectrum
+
+  TLorentzVector vgen;
+  unsigned long nread = 0, nbroken = 0;
+  Double_t nfill0 = smp.GetNFill();
+
+  while( LoadInputEvent(vgen) ) {
+    nread++;
+    if( vgen.M() < 0.1 ) {
+      nbroken++;
+      continue;
     }
 
-  }//input event loop
+    smp.Fill(vgen.Pt(), vgen.Rapidity());
+  }
 
-  cout << "Rejected input events: " << nreject << endl;
-  cout << "Events written: " << iev << endl;
+  unsigned long nfill = (unsigned long)(smp.GetNFill() - nfill0 + 0.5);
+  unsigned long nout = nread - nbroken - nfill;
 
-}//EventLoop
+  cout << "TGenPsi2S: " << nfill << " of " << nread << " input events in kinematics sampler";
+  cout << ", " << nbroken << " broken" << endl;
+  if( nout > 0 ) {
+    cout << "TGenPsi2S: " << nout << " input events outside the sampler ranges, spectrum is truncated" << endl;
+  }
+
+  return smp.Build();
+
+}//FillSampler
 
 //_____________________________________________________________________________
-bool TGenPsi2S::PolarizedJpsi() {
+void TGenPsi2S::SetSampler(TKinSampler *smp, unsigned long nev, unsigned int stream) {
+
+  //nev parents generated by the sampler instead of reading the input, the generator
+  //takes ownership of the sampler; parallel jobs use different streams, the stream
+  //selects the seeds for the sampler, for the polarized decays in all channels and
+  //for the Pythia8 parent decays, so that each job is independent and reproducible
 
-  //polarized J/psi -> e+e- decay
+  delete fSampler;
+  fSampler = smp;
+  fSmpNev = nev;
 
-  int idx;
-  for(int i=0; i<fPart->GetEntries(); i++) {
-    TParticle *part = dynamic_cast<TParticle*>( fPart->At(i) );
+  fStream = stream;
 
-    if( part->GetPdgCode() == 443 ) {
-      idx = i;
-      break;
+  delete fSmpRnd;
+  fSmpRnd = new TRandom3(4357 + 65539*fStream);
+
+  for(unsigned int i=0; i<fChan.size(); i++) fChan[i]->SetSeed( ChannelSeed(i) );
+
+  fSmpBlock.resize(4*4096);
+  fSmpPos = fSmpBlock.size()/4;
+
+}//SetSampler
+
+//_____________________________________________________________________________
+void TGenPsi2S::InitDecay() {
+
+  //TPythia8Decayer with import to TClonesArray, or Pythia8 used directly,
+  //stream 0 keeps the Pythia8 default seed
+
+  UInt_t seed = fStream > 0 ? 19780503 + fStream : 0;
+
+  if( fDecay == kPythia8 and !fDec8 ) fDec8 = new TDecayPythia8(seed);
+
+  if( fDecay == kDecayer and !fDec ) {
+    fDec = new TPythia8Decayer();
+    fDec->Init();
+
+    //the decayer runs on the TPythia8 instance, initialized again with the seed
+    TPythia8 *py8 = TPythia8::Instance();
+    if( seed != 0 and py8 ) {
+      py8->ReadString("Random:setSeed = on");
+      py8->ReadString( ("Random:seed = " + to_string(seed)).c_str() );
+      py8->Pythia8()->init();
     }
   }
 
-  //original J/psi Lorentz vector and removal from decay clones array
-  TParticle *pjpsi = dynamic_cast<TParticle*>( fPart->At(idx) );
-  TLorentzVector vjpsi;
-  pjpsi->Momentum(vjpsi);
-  fPart->RemoveAt(idx);
-  fPart->Compress();
+}//InitDecay
 
-  //J/psi kinematics in output tree
-  jGenPt = vjpsi.Pt();
-  jGenPt2 = jGenPt*jGenPt;
-  jGenY = vjpsi.Rapidity();
-  jGenPhi = vjpsi.Phi();
+//_____________________________________________________________________________
+bool TGenPsi2S::Decay(unsigned int ichan, TLorentzVector& vgen) {
 
-  //generate the decay
-  fPol->Generate(vjpsi);
+  if( fDecay == kPythia8 ) return fChan[ichan]->Decay(fDec8, vgen);
 
-  //store all psi(2S) decay products including polarized J/psi
-  fVecPol.clear();
-  fVecPol.resize( fPart->GetEntries() + 2 );
+  return fChan[ichan]->Decay(fDec, vgen);
 
-  fVecPol[0] = fPol->GetDecay(0);
-  fVecPol[1] = fPol->GetDecay(1);
+}//Decay
 
-  for(int i=0; i<fPart->GetEntries(); i++) {
-    fVecPol[i+2] = dynamic_cast<TParticle*>( fPart->At(i) );
-  }
+//_____________________________________________________________________________
+void TGenPsi2S::ClearChannels() {
+
+  for(unsigned int i=0; i<fChan.size(); i++) delete fChan[i];
+  fChan.clear();
 
-  if( !fUseEta ) return true;
+}//ClearChannels
 
-  //evaluate the requested pseudorapidity interval
+//_____________________________________________________________________________
+void TGenPsi2S::SetEtaRange(double etamin, double etamax) {
 
-  double eta0 = fPol->GetDecay(0)->Eta();
-  double eta1 = fPol->GetDecay(1)->Eta();
+  //set pseudorapidity interval for both leptons from vector meson decay
 
-  if( eta0 < fEtaMin or eta0 > fEtaMax ) return false;
-  if( eta1 < fEtaMin or eta1 > fEtaMax ) return false;
+  for(unsigned int i=0; i<fChan.size(); i++) fChan[i]->SetEtaRange(etamin, etamax);
 
-  //decay passed the pseudorapidity interval
+}//SetEtaRange
+
+//_____________________________________________________________________________
+bool TGenPsi2S::SetCuts(const string& cfg) {
+
+  //selection on leptons, all decay products or the dilepton, each channel has its own cut flow
+
+  for(unsigned int i=0; i<fChan.size(); i++) {
+    if( !fChan[i]->SetCuts(cfg) ) return false;
+  }
 
   return true;
 
-}//PolarizedJpsi
+}//SetCuts
 
 //_____________________________________________________________________________
-void TGenPsi2S::KeepFinalOnly() {
+bool TGenPsi2S::SetHistConfig(const string& cfg) {
 
-  //keep only J/psi and final products of psi(2S) decay, also dileptons from J/psi
-  //decay are removed since polarized decay will follow
+  //histogram mode, only histograms booked in cfg are written
 
-  vector<int> to_remove;
-  to_remove.reserve(fPart->GetEntries());
+  for(unsigned int i=0; i<fChan.size(); i++) {
+    if( !fChan[i]->SetHistConfig(cfg) ) return false;
+  }
 
-  for(int i=0; i<fPart->GetEntries(); i++) {
-    TParticle *part = dynamic_cast<TParticle*>( fPart->At(i) );
+  return true;
 
-    if( part->GetPdgCode() == 443 ) {
-      to_remove.push_back( part->GetFirstDaughter() );
-      to_remove.push_back( part->GetLastDaughter() );
-      continue;
-    }
+}//SetHistConfig
+
+//_____________________________________________________________________________
+bool TGenPsi2S::SetPolConfig(const string& cfg) {
+
+  //frame and polarization hypotheses for per-event weights
 
-    if( part->GetNDaughters() > 0 ) to_remove.push_back(i);
+  for(unsigned int i=0; i<fChan.size(); i++) {
+    if( !fChan[i]->SetPolConfig(cfg) ) return false;
   }
 
-  for(vector<int>::const_iterator it = to_remove.cbegin(); it != to_remove.cend(); ++it) {
-    fPart->RemoveAt(*it);
+  return true;
+
+}//SetPolConfig
+
+//_____________________________________________________________________________
+void TGenPsi2S::AddPolHypothesis(double lth, double lph, double ltp) {
+
+  for(unsigned int i=0; i<fChan.size(); i++) fChan[i]->AddPolHypothesis(lth, lph, ltp);
+
+}//AddPolHypothesis
+
+//_____________________________________________________________________________
+void TGenPsi2S::SetTxIndex(const string& name) {
+
+  //event index for .tx output, for more channels each index is placed next to
+  //the channel .tx under the name expected by txextract and txmerge
+
+  if( fChan.size() == 1 ) {
+    fChan[0]->SetTxIndex(name);
+    return;
   }
 
-  fPart->Compress();
+  for(unsigned int i=0; i<fChan.size(); i++) {
+    fChan[i]->SetTxIndex( TTxIndex::IndexName(fChan[i]->GetTxName()) );
+  }
 
-}//KeepFinalOnly
+}//SetTxIndex
 
 //_____________________________________________________________________________
-bool TGenPsi2S::AcceptDecay() {
+void TGenPsi2S::EventLoop() {
+
+  unsigned long iev = 0;
+  unsigned long nprint = 5e5;
+
+  InitDecay();
 
-  //select J/psi dilepton decays
+  for(unsigned int i=0; i<fChan.size(); i++) fChan[i]->OpenOutput();
 
-  int idx0=0, idx1=0;
-  for(int i=0; i<fPart->GetEntries(); i++) {
-    TParticle *part = dynamic_cast<TParticle*>( fPart->At(i) );
+  //input event loop
+  while(true) {
+
+    if(iev > fNevt and fNevt != 0) break;
 
-    if( part->GetPdgCode() == 443 ) {
-      idx0 = part->GetFirstDaughter();
-      idx1 = part->GetLastDaughter();
-      break;
+    //original parent event, end of input or rejected event
+    TLorentzVector vgen;
+    int stat = NextInput(vgen);
+    if( stat < 0 ) break;
+    if( stat == 0 ) continue;
+
+    //decay in all channels, the same input event for each
+    bool written = false;
+    for(unsigned int i=0; i<fChan.size(); i++) {
+      if( !Decay(i, vgen) ) continue;
+      fChan[i]->WriteEvent();
+      written = true;
     }
-  }
 
-  if( idx0 <= 0 or idx1 <= 0 or TMath::Abs(idx1-idx0) != 1 ) return false;
+    //single channel counts written events, more channels count decayed input events
+    if( fChan.size() == 1 and !written ) continue;
+    iev++;
 
-  if( !AcceptParticle(idx0) or !AcceptParticle(idx1) ) return false;
+    if (iev != 0 and iev%nprint == 0) {
+      cout << "processed " << iev << " events" << endl;
+    }
 
-  return true;
+  }//input event loop
 
-}//AcceptDecay
+  for(unsigned int i=0; i<fChan.size(); i++) fChan[i]->Print();
+
+  cout << "Rejected input events: " << fNreject << endl;
+  if( fChan.size() == 1 ) {
+    cout << "Events written: " << iev << endl;
+  } else {
+    cout << "Input events decayed: " << iev << endl;
+  }
+
+}//EventLoop
 
 //_____________________________________________________________________________
-bool TGenPsi2S::AcceptParticle(int idx) {
+unsigned int TGenPsi2S::FillBatch(TEventBatch& batch, unsigned int nev) {
 
-  TParticle *part = dynamic_cast<TParticle*>( fPart->At(idx) );
+  //decayed events of the first channel to the batch, no .tx, tree or histogram output
 
-  int pdg = part->GetPdgCode();
+  batch.Clear();
 
-  if( TMath::Abs(pdg) != 11 and TMath::Abs(pdg) != 13 ) return false;
+  InitDecay();
 
-  return true;
+  unsigned int iev = 0;
+  while( iev < nev ) {
 
-}//AcceptParticle
+    int stat = NextEvent();
+    if( stat < 0 ) break;
+    if( stat == 0 ) continue;
 
-//_____________________________________________________________________________
-bool TGenPsi2S::LoadInputEvent(TLorentzVector& vgen) {
+    const vector<const TParticle*>& part = fChan[0]->GetParticles();
+    for(unsigned int i=0; i<part.size(); i++) batch.AddParticle( part[i] );
+    batch.EndEvent();
 
-  string line;
+    iev++;
+  }
 
-  //event and vertex lines
-  getline(fInp, line);
-  if( !fInp.good() ) return false;
-  getline(fInp, line);
+  return iev;
 
-  //particle lines
-  TLorentzVector v0, v1;
-  getline(fInp, line);
-  LoadParticle(v0, line);
+}//FillBatch
 
-  getline(fInp, line);
-  LoadParticle(v1, line);
+//_____________________________________________________________________________
+int TGenPsi2S::NextEvent() {
 
-  vgen = v0 + v1;
+  //load and decay next input event in the first channel, returns 1
+  //for accepted event, 0 for rejected and -1 at the end of input
 
-  return true;
+  TLorentzVector vgen;
+  int stat = NextInput(vgen);
+  if( stat <= 0 ) return stat;
 
-}//LoadInputEvent
+  if( !Decay(0, vgen) ) return 0;
+
+  return 1;
+
+}//NextEvent
 
 //_____________________________________________________________________________
-void TGenPsi2S::LoadParticle(TLorentzVector& pvec, const std::string& line) {
+int TGenPsi2S::NextInput(TLorentzVector& vgen) {
 
-  //cout << line << endl;
+  //next input parent, returns 1 for valid event, 0 for rejected and -1 at the end of input
+  //or when the input does not match the channel parents
 
-  char_separator<char> sep(" ");
-  tokenizer<char_separator<char>> tok(line, sep);
-  tokenizer<char_separator<char>>::iterator trk_it=tok.begin();
+  if( fSampler ) {
+    if( !SampleInputEvent(vgen) ) return -1;
+    return CheckParents(vgen) ? 1 : -1;
+  }
 
-  //particle momentum
-  ++trk_it; ++trk_it;
-  Double_t pxyz[3];
-  for(int i=0; i<3; i++) pxyz[i] = stod( *(trk_it++) );
+  if( !LoadInputEvent(vgen) ) return -1;
+  ++fNinp;
 
-  //particle pdg
-  for(int i=0; i<3; i++) ++trk_it;
-  int pdg = stoi( *trk_it );
+  //reject broken input events
+  if( vgen.M() < 0.1 ) {
 
-  //set particle Lorentz vector
-  pvec.SetXYZM(pxyz[0], pxyz[1], pxyz[2], fPdgDat->GetParticle(pdg)->Mass());
+    cout << "TGenPsi2S: rejecting input event: ";
+    cout << fNinp << " ";
+    cout << vgen.Pt() << " " << vgen.Rapidity() << " ";
+    cout << vgen.M() << endl;
 
-}//LoadParticle
+    ++fNreject;
+
+    return 0;
+  }
+
+  if( !CheckParents(vgen) ) return -1;
+
+  return 1;
+
+}//NextInput
 
 //_____________________________________________________________________________
-void TGenPsi2S::WriteStarlight() {
+bool TGenPsi2S::CheckParents(const TLorentzVector& vgen) {
 
-  //write output in Starlight .tx format
+  //all channels decay the same input particle, the parent of each channel
+  //must have the input mass, checked on the first valid input event
 
-  std::ostringstream tx;
+  if( fParentChecked ) return true;
 
-  tx << fEvtline << fNtx << " " << fVecPol.size() << " 1" << endl;
-  tx << fVtxline << fVecPol.size() << endl;
-  for(unsigned int i=0; i<fVecPol.size(); i++) PutTxTrack(tx, i);
+  const Double_t dmmax = 0.05; // GeV, below the spacing of charmonium states
 
-  fTxOut << tx.str();
+  bool stat = true;
+  for(unsigned int i=0; i<fChan.size(); i++) {
 
-  ++fNtx;
+    Double_t mpar = TPdgTable::Mass( fChan[i]->GetParent() );
+    if( TMath::Abs(vgen.M() - mpar) < dmmax ) continue;
 
-}//WriteStarlight
+    cout << "TGenPsi2S: parent " << fChan[i]->GetParent() << " of channel " << i << " has mass " << mpar;
+    cout << ", input mass is " << vgen.M() << endl;
+    stat = false;
+  }
+
+  if( !stat ) {
+    cout << "TGenPsi2S: channels do not match the input parent, generation stopped" << endl;
+    return false;
+  }
+
+  fParentChecked = true;
+
+  return true;
+
+}//CheckParents
 
 //_____________________________________________________________________________
-void TGenPsi2S::PutTxTrack(ostringstream &tx, unsigned int ipart) {
+bool TGenPsi2S::LoadInputEvent(TLorentzVector& vgen) {
 
-  //utility function for Starlight .tx format
+  string line;
 
-  tx << "TRACK:  " << fPdgDat->ConvertPdgToGeant3( fVecPol[ipart]->GetPdgCode() ) << " ";
-  tx << fixed << fVecPol[ipart]->Px() << " ";
-  tx << fixed << fVecPol[ipart]->Py() << " ";
-  tx << fixed << fVecPol[ipart]->Pz() << " ";
-  tx << fNtx << " " << ipart << " 0 ";
-  tx << fVecPol[ipart]->GetPdgCode() << endl;
+  //parent from the cache instead of text parsing
+  if( fCache and fCacheRead ) return fCache->Next(vgen);
 
-}//put_tx_track
+  //event and vertex lines, cache is complete at the end of input
+  if( !fInp->GetLine(line) ) {
+    if( fCache ) fCache->Finish();
+    return false;
+  }
+  fInp->GetLine(line);
 
+  //particle lines
+  TLorentzVector v0, v1;
+  fInp->GetLine(line);
+  LoadParticle(v0, line);
 
+  fInp->GetLine(line);
+  LoadParticle(v1, line);
 
+  vgen = v0 + v1;
 
+  if( fCache ) fCache->Add(vgen);
 
+  return true;
 
+}//LoadInputEvent
 
+//_____________________________________________________________________________
+bool TGenPsi2S::SampleInputEvent(TLorentzVector& vgen) {
+
+  //parent from the sampler, generated in blocks, false after the requested number
+
+  if( fNinp >= fSmpNev ) return false;
 
+  unsigned int nblock = fSmpBlock.size()/4;
+  if( fSmpPos >= nblock ) {
+    Double_t mass = TPdgTable::Mass( fChan[0]->GetParent() );
+    fSampler->Generate(*fSmpRnd, mass, nblock, &fSmpBlock[0]);
+    fSmpPos = 0;
+  }
 
+  const Double_t *p = &fSmpBlock[4*fSmpPos];
+  vgen.SetPxPyPzE(p[0], p[1], p[2], p[3]);
 
+  ++fSmpPos;
+  ++fNinp;
 
+  return true;
 
+}//SampleInputEvent
 
+//_____________________________________________________________________________
+void TGenPsi2S::LoadParticle(TLorentzVector& pvec, const std::string& line) {
+
+  //cout << line << endl;
+
+  char_separator<char> sep(" ");
+  tokenizer<char_separator<char>> tok(line, sep);
+  tokenizer<char_separator<char>>::iterator trk_it=tok.begin();
 
+  //particle momentum
+  ++trk_it; ++trk_it;
+  Double_t pxyz[3];
+  for(int i=0; i<3; i++) pxyz[i] = stod( *(trk_it++) );
 
+  //particle pdg
+  for(int i=0; i<3; i++) ++trk_it;
+  int pdg = stoi( *trk_it );
 
+  //set particle Lorentz vector
+  pvec.SetXYZM(pxyz[0], pxyz[1], pxyz[2], TPdgTable::Mass(pdg));
 
+}//LoadParticle
 
 
@@ -6,7 +6,6 @@
 #include <sstream>
 
 //ROOT headers
-#include "TDatabasePDG.h"
 #include "TRandom3.h"
 #include "TMath.h"
 #include "TLorentzVector.h"
@@ -16,26 +15,32 @@
 //local headers
 #include "TDecayPolarized.h"
 #include "TGenUPCJpsiFlat.h"
+#include "TCompStream.h"
+#include "TAccMap.h"
+#include "TCutEngine.h"
+#include "TPdgTable.h"
+#include "TTxIndex.h"
 
 //_____________________________________________________________________________
-TGenUPCJpsiFlat::TGenUPCJpsiFlat(Double_t pt2max, Double_t etamin, Double_t etamax):
-  fPt2Max(pt2max), fEtaMin(etamin), fEtaMax(etamax), fNtx(1) {
+TGenUPCJpsiFlat::TGenUPCJpsiFlat(Double_t pt2max, Double_t etamin, Double_t etamax, const std::string& txout):
+  fPt2Max(pt2max), fEtaMin(etamin), fEtaMax(etamax), fAccMap(0x0), fWeight(1), fCuts(0x0), fNtx(1), fTxIdx(0x0) {
 
   fEtaRange = etamax - etamin;
 
   fPhiMin = -TMath::Pi();
   fPhiRange = 2*TMath::Pi();
 
-  fPdgDat = TDatabasePDG::Instance();
-  fMass = fPdgDat->GetParticle(443)->Mass();
+  fMass = TPdgTable::Mass(443);
 
   fRand = new TRandom3();
   fRand->SetSeed(5572323);
 
-  fDec = new TDecayPolarized();
+  fDec = new TDecayPolarized(kLeptonPdg);
   fPart.resize(2);
 
-  fTxOut.open("output.tx");
+  //compression by extension of output name, .tx.gz or .tx.zst, no output for empty name
+  fTxOut = 0x0;
+  if( !txout.empty() ) fTxOut = new TCompOutput(txout);
   evtline[0] = "EVENT: ";
   evtline[1] = " 2 1";
   vtxline = "VERTEX: 0 0 0 0 1 0 0 2";
@@ -45,47 +50,96 @@ TGenUPCJpsiFlat::TGenUPCJpsiFlat(Double_t pt2max, Double_t etamin, Double_t etam
 //_____________________________________________________________________________
 TGenUPCJpsiFlat::~TGenUPCJpsiFlat() {
 
-  fTxOut.close();
+  if( fTxOut ) {
+    if( !fTxOut->Close() ) std::cout << "TGenUPCJpsiFlat: write error, .tx output is incomplete" << std::endl;
+    delete fTxOut;
+  }
+  delete fTxIdx;
 
   delete fRand;
   delete fDec;
+  delete fCuts;
 
 }//~TGenUPCJpsiFlat
 
 //_____________________________________________________________________________
-void TGenUPCJpsiFlat::GenerateEvent() {
+void TGenUPCJpsiFlat::SetSeed(UInt_t seed) {
+
+  //random sequences for kinematics and decay, distinct seeds allow
+  //for independent generators in parallel threads
+
+  fRand->SetSeed(seed);
+  fDec->SetSeed(seed+1);
+
+}//SetSeed
+
+//_____________________________________________________________________________
+bool TGenUPCJpsiFlat::SetCuts(const std::string& cfg) {
+
+  //selection applied to the decay in the generating loop
+
+  delete fCuts;
+  fCuts = new TCutEngine();
+
+  return fCuts->LoadConfig(cfg);
+
+}//SetCuts
+
+//_____________________________________________________________________________
+void TGenUPCJpsiFlat::PrintCuts() const {
+
+  if( fCuts ) fCuts->Print();
+
+}//PrintCuts
+
+//_____________________________________________________________________________
+Bool_t TGenUPCJpsiFlat::GenerateTrial() {
+
+  //single J/psi decay, true when both daughters are in the fiducial eta range
+
+  //initial pT^2, rapidity and phi
+  Double_t pt2 = fPt2Max * fRand->Rndm();
+  Double_t pt = TMath::Sqrt(pt2);
+  Double_t yval = fEtaMin + fEtaRange * fRand->Rndm();
+  Double_t phi = fPhiMin + fPhiRange * fRand->Rndm();
+
+  //J/psi Lorentz vector
+  TLorentzVector vjpsi;
+  vjpsi.SetPtEtaPhiM(pt, eta_from_y(yval, pt), phi, fMass);
+
+  //polarized decay
+  fDec->Generate(vjpsi);
+
+  fPart[0] = fDec->GetDecay(0);
+  fPart[1] = fDec->GetDecay(1);
 
-  //generating loop
-  while(1) {
+  //test for the fiducial eta range
+  Double_t eta0 = fDec->GetDecay(0)->Eta();
+  Double_t eta1 = fDec->GetDecay(1)->Eta();
 
-    //initial pT^2, rapidity and phi
-    Double_t pt2 = fPt2Max * fRand->Rndm();
-    Double_t pt = TMath::Sqrt(pt2);
-    Double_t yval = fEtaMin + fEtaRange * fRand->Rndm();
-    Double_t phi = fPhiMin + fPhiRange * fRand->Rndm();
+  return (eta0>fEtaMin && eta0<fEtaMax) && (eta1>fEtaMin && eta1<fEtaMax);
 
-    //J/psi Lorentz vector
-    TLorentzVector vjpsi;
-    vjpsi.SetPtEtaPhiM(pt, eta_from_y(yval, pt), phi, fMass);
+}//GenerateTrial
 
-    //polarized decay
-    fDec->Generate(vjpsi);
+//_____________________________________________________________________________
+void TGenUPCJpsiFlat::GenerateEvent() {
 
-    //test for the fiducial eta range
-    Double_t eta0 = fDec->GetDecay(0)->Eta();
-    Double_t eta1 = fDec->GetDecay(1)->Eta();
+  //weighted mode, every decay is kept with acceptance from the map as weight
+  if( fAccMap ) {
 
-    if( (eta0>fEtaMin && eta0<fEtaMax) && (eta1>fEtaMin && eta1<fEtaMax) ) {
+    GenerateTrial();
 
-      //event accepted by pseudorapidity interval
+    Double_t val[3];
+    TAccMap::Vars(fPart[0], fPart[1], val);
+    fWeight = fAccMap->Eval(val);
 
-      fPart[0] = fDec->GetDecay(0);
-      fPart[1] = fDec->GetDecay(1);
+    if( fCuts and !fCuts->Accept(fPart) ) fWeight = 0;
 
-      break;
-    }
+    return;
+  }
 
-  }//generating loop
+  //generating loop, until the event is accepted by pseudorapidity interval and the cuts
+  while( !GenerateTrial() or (fCuts and !fCuts->Accept(fPart)) ) {}
 
 }//GenerateEvent
 
@@ -102,16 +156,65 @@ Int_t TGenUPCJpsiFlat::ImportParticles(TClonesArray *particles, Option_t *opt) {
 
 }//ImportParticles
 
+//_____________________________________________________________________________
+unsigned int TGenUPCJpsiFlat::FillBatch(TEventBatch& batch, unsigned int nev) {
+
+  //generate nev events to the batch, without the .tx output
+
+  batch.Clear();
+
+  for(unsigned int i=0; i<nev; i++) {
+
+    GenerateEvent();
+
+    batch.AddParticle(fPart[0]);
+    batch.AddParticle(fPart[1]);
+    batch.EndEvent(fWeight);
+  }
+
+  return nev;
+
+}//FillBatch
+
+//_____________________________________________________________________________
+bool TGenUPCJpsiFlat::SetTxIndex(const std::string& name) {
+
+  //event index along the .tx output
+
+  if( !fTxOut ) return false;
+
+  delete fTxIdx;
+  fTxIdx = new TTxIndex();
+  if( fTxIdx->Create(name) ) return true;
+
+  delete fTxIdx;
+  fTxIdx = 0x0;
+
+  return false;
+
+}//SetTxIndex
+
 //_____________________________________________________________________________
 void TGenUPCJpsiFlat::WriteStarlight() {
 
+  if( !fTxOut ) return;
+
+  //offset and dilepton kinematics of the event before it is written
+  if( fTxIdx ) {
+    TLorentzVector l0, l1;
+    fPart[0]->Momentum(l0);
+    fPart[1]->Momentum(l1);
+    TLorentzVector vm = l0 + l1;
+    fTxIdx->Add(fNtx, fTxOut->Tell(), vm.Rapidity(), vm.Pt());
+  }
+
   //output in Starlight format
   std::ostringstream tx;
   tx << evtline[0] << fNtx << evtline[1] << std::endl;
   tx << vtxline << std::endl;
   put_tx_track(tx, 0);
   put_tx_track(tx, 1);
-  fTxOut << tx.str();
+  fTxOut->Write(tx.str());
   fNtx++;
 
 }//
@@ -139,7 +242,7 @@ void TGenUPCJpsiFlat::put_tx_track(std::ostringstream &tx, int ipart) {
 
   //utility function for Starlight .tx format
 
-  tx << "TRACK:  " << fPdgDat->ConvertPdgToGeant3(fPart[ipart]->GetPdgCode()) << " ";
+  tx << "TRACK:  " << TPdgTable::Geant3(fPart[ipart]->GetPdgCode()) << " ";
   tx << fPart[ipart]->Px() << " " << fPart[ipart]->Py() << " " << fPart[ipart]->Pz();
   tx << " " << fNtx << " " << ipart << " 0 " << fPart[ipart]->GetPdgCode() << std::endl;
 
@@ -0,0 +1,250 @@
+
+//C++ headers
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+//ROOT headers
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TH3D.h"
+#include "TMath.h"
+
+//local headers
+#include "THistAccum.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+THistAccum::THistAccum(const vector<string>& vars): fVars(vars), fNcells(0) {
+
+  fSlot.resize(1);
+
+}//THistAccum
+
+//_____________________________________________________________________________
+bool THistAccum::LoadConfig(const string& cfg) {
+
+  //histograms from configuration file, one histogram per line:
+  //
+  //  h1 name var nbins min max
+  //  h2 name varx nx xmin xmax vary ny ymin ymax
+  //  h3 name varx nx xmin xmax vary ny ymin ymax varz nz zmin zmax
+  //
+  //variables are the names given in constructor, lines starting with '#' are comments
+
+  ifstream in(cfg.c_str());
+  if( !in.is_open() ) {
+    cout << "THistAccum: can not open " << cfg << endl;
+    return false;
+  }
+
+  string line;
+  while( getline(in, line) ) {
+
+    istringstream ss(line);
+
+    string key;
+    if( !(ss >> key) or key[0] == '#' ) continue;
+
+    int ndim = 0;
+    if( key == "h1" ) ndim = 1;
+    if( key == "h2" ) ndim = 2;
+    if( key == "h3" ) ndim = 3;
+
+    string name;
+    vector<string> vars(ndim);
+    vector<int> nbins(ndim);
+    vector<double> vmin(ndim), vmax(ndim);
+
+    ss >> name;
+    for(int i=0; i<ndim; i++) ss >> vars[i] >> nbins[i] >> vmin[i] >> vmax[i];
+
+    if( ndim == 0 or ss.fail() ) {
+      cout << "THistAccum: invalid line in " << cfg << ": " << line << endl;
+      return false;
+    }
+
+    if( !Book(name, vars, nbins, vmin, vmax) ) return false;
+  }
+
+  return true;
+
+}//LoadConfig
+
+//_____________________________________________________________________________
+bool THistAccum::Book(const string& name, const vector<string>& vars,
+  const vector<int>& nbins, const vector<double>& vmin, const vector<double>& vmax) {
+
+  //book new histogram, all slots are reset
+
+  HistDef hd;
+  hd.name = name;
+  hd.ndim = vars.size();
+
+  if( hd.ndim < 1 or hd.ndim > 3 ) {
+    cout << "THistAccum: only 1D, 2D and 3D histograms (" << name << ")" << endl;
+    return false;
+  }
+
+  hd.ncells = 1;
+  for(int i=0; i<3; i++) {
+
+    hd.ivar[i] = 0;
+    hd.nbins[i] = 0;
+    hd.vmin[i] = 0;
+    hd.vmax[i] = 0;
+    hd.scale[i] = 0;
+
+    if( i >= hd.ndim ) continue;
+
+    hd.ivar[i] = GetVarIndex(vars[i]);
+    if( hd.ivar[i] < 0 ) {
+      cout << "THistAccum: unknown variable " << vars[i] << " for " << name << endl;
+      return false;
+    }
+    if( nbins[i] < 1 or vmax[i] <= vmin[i] ) {
+      cout << "THistAccum: invalid binning for " << name << endl;
+      return false;
+    }
+
+    hd.nbins[i] = nbins[i];
+    hd.vmin[i] = vmin[i];
+    hd.vmax[i] = vmax[i];
+    hd.scale[i] = nbins[i]/(vmax[i]-vmin[i]);
+
+    //bins together with underflow and overflow, same as global bin in ROOT
+    hd.ncells *= nbins[i] + 2;
+  }
+
+  hd.offset = fNcells;
+  fNcells += hd.ncells;
+
+  fHist.push_back(hd);
+
+  SetNSlots( fSlot.size() );
+
+  return true;
+
+}//Book
+
+//_____________________________________________________________________________
+void THistAccum::SetNSlots(unsigned int nslot) {
+
+  //accumulators for nslot threads, contents are reset
+
+  fSlot.clear();
+  fSlot.resize(nslot);
+
+  for(unsigned int i=0; i<nslot; i++) {
+    fSlot[i].sumw.assign(fNcells, 0);
+    fSlot[i].sumw2.assign(fNcells, 0);
+    fSlot[i].nfill.assign(fHist.size(), 0);
+  }
+
+}//SetNSlots
+
+//_____________________________________________________________________________
+int THistAccum::GetVarIndex(const string& var) const {
+
+  for(unsigned int i=0; i<fVars.size(); i++) {
+    if( fVars[i] == var ) return i;
+  }
+
+  return -1;
+
+}//GetVarIndex
+
+//_____________________________________________________________________________
+int THistAccum::FindBin(const HistDef& hd, int iaxis, Double_t val) const {
+
+  //bin along the axis, 0 for underflow and nbins+1 for overflow
+
+  if( val < hd.vmin[iaxis] ) return 0;
+  if( val >= hd.vmax[iaxis] ) return hd.nbins[iaxis] + 1;
+
+  int ibin = 1 + int( (val - hd.vmin[iaxis])*hd.scale[iaxis] );
+
+  //rounding at the upper edge
+  if( ibin > hd.nbins[iaxis] ) ibin = hd.nbins[iaxis];
+
+  return ibin;
+
+}//FindBin
+
+//_____________________________________________________________________________
+void THistAccum::Fill(unsigned int slot, const Double_t *val, Double_t w) {
+
+  //fill all histograms in a given slot, val is indexed by the variables from constructor
+
+  Slot& sl = fSlot[slot];
+
+  for(unsigned int ih=0; ih<fHist.size(); ih++) {
+
+    const HistDef& hd = fHist[ih];
+
+    //global bin, x + (nx+2)*(y + (ny+2)*z)
+    unsigned long icell = 0;
+    for(int i=hd.ndim-1; i>=0; i--) {
+      icell = icell*(hd.nbins[i]+2) + FindBin(hd, i, val[hd.ivar[i]]);
+    }
+
+    sl.sumw[hd.offset + icell] += w;
+    sl.sumw2[hd.offset + icell] += w*w;
+    sl.nfill[ih]++;
+  }
+
+}//Fill
+
+//_____________________________________________________________________________
+void THistAccum::Write() {
+
+  //merge the slots to ROOT histograms and write them to the current directory
+
+  for(unsigned int ih=0; ih<fHist.size(); ih++) {
+
+    const HistDef& hd = fHist[ih];
+
+    string title = fVars[ hd.ivar[0] ];
+    if( hd.ndim > 1 ) title += ":" + fVars[ hd.ivar[1] ];
+    if( hd.ndim > 2 ) title += ":" + fVars[ hd.ivar[2] ];
+
+    TH1 *hx = 0x0;
+    if( hd.ndim == 1 ) {
+      hx = new TH1D(hd.name.c_str(), title.c_str(), hd.nbins[0], hd.vmin[0], hd.vmax[0]);
+    }
+    if( hd.ndim == 2 ) {
+      hx = new TH2D(hd.name.c_str(), title.c_str(), hd.nbins[0], hd.vmin[0], hd.vmax[0],
+        hd.nbins[1], hd.vmin[1], hd.vmax[1]);
+    }
+    if( hd.ndim == 3 ) {
+      hx = new TH3D(hd.name.c_str(), title.c_str(), hd.nbins[0], hd.vmin[0], hd.vmax[0],
+        hd.nbins[1], hd.vmin[1], hd.vmax[1], hd.nbins[2], hd.vmin[2], hd.vmax[2]);
+    }
+    hx->Sumw2();
+
+    //sum over slots
+    unsigned long nfill = 0;
+    for(unsigned int is=0; is<fSlot.size(); is++) nfill += fSlot[is].nfill[ih];
+
+    for(unsigned long icell=0; icell<hd.ncells; icell++) {
+
+      Double_t sumw = 0, sumw2 = 0;
+      for(unsigned int is=0; is<fSlot.size(); is++) {
+        sumw += fSlot[is].sumw[hd.offset + icell];
+        sumw2 += fSlot[is].sumw2[hd.offset + icell];
+      }
+
+      hx->SetBinContent(icell, sumw);
+      hx->SetBinError(icell, TMath::Sqrt(sumw2));
+    }
+
+    hx->ResetStats();
+    hx->SetEntries(nfill);
+
+    hx->Write();
+    delete hx;
+  }
+
+}//Write
+
@@ -0,0 +1,210 @@
+
+//C++ headers
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//ROOT headers
+#include "TLorentzVector.h"
+
+//local headers
+#include "TInputCache.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+TInputCache::TInputCache(): fMap(0x0), fMapSize(0), fRec(0x0), fNevt(0), fIev(0), fOut(0x0) {
+
+  memset(&fHdr, 0, sizeof(Header));
+
+}//TInputCache
+
+//_____________________________________________________________________________
+TInputCache::~TInputCache() {
+
+  Close();
+
+  //unfinished cache is discarded
+  if( fOut ) {
+    fclose(fOut);
+    unlink( fTmpName.c_str() );
+  }
+
+}//~TInputCache
+
+//_____________________________________________________________________________
+bool TInputCache::SourceKey(const string& inp, Header& hdr) {
+
+  //size and modification time of the input identify the cache
+
+  struct stat st;
+  if( stat(inp.c_str(), &st) != 0 ) return false;
+
+  memcpy(hdr.tag, "TSLCACH1", 8);
+  hdr.size = st.st_size;
+  hdr.mtime = st.st_mtim.tv_sec;
+  hdr.mtime_ns = st.st_mtim.tv_nsec;
+
+  return true;
+
+}//SourceKey
+
+//_____________________________________________________________________________
+bool TInputCache::Open(const string& name, const string& inp) {
+
+  //map the cache, false when it is missing or does not match the input
+
+  Header key;
+  if( !SourceKey(inp, key) ) return false;
+
+  int fd = open(name.c_str(), O_RDONLY);
+  if( fd < 0 ) return false;
+
+  struct stat st;
+  if( fstat(fd, &st) != 0 or size_t(st.st_size) < sizeof(Header) ) {
+    close(fd);
+    return false;
+  }
+
+  fMapSize = st.st_size;
+  fMap = mmap(0x0, fMapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if( fMap == MAP_FAILED ) {
+    fMap = 0x0;
+    return false;
+  }
+
+  //cache made from the same input and complete
+  const Header *hdr = static_cast<const Header*>(fMap);
+  bool valid = memcmp(hdr->tag, key.tag, 8) == 0 and hdr->size == key.size;
+  valid = valid and hdr->mtime == key.mtime and hdr->mtime_ns == key.mtime_ns;
+  valid = valid and fMapSize == sizeof(Header) + hdr->nev*4*sizeof(Double_t);
+
+  if( !valid ) {
+    cout << "TInputCache: " << name << " does not match " << inp << ", not used" << endl;
+    Close();
+    return false;
+  }
+
+  madvise(fMap, fMapSize, MADV_SEQUENTIAL);
+
+  fNevt = hdr->nev;
+  fRec = reinterpret_cast<const Double_t*>( static_cast<const char*>(fMap) + sizeof(Header) );
+  fIev = 0;
+
+  return true;
+
+}//Open
+
+//_____________________________________________________________________________
+bool TInputCache::Next(TLorentzVector& vgen) {
+
+  //next parent four-vector, false at the end of cache
+
+  if( fIev >= fNevt ) return false;
+
+  const Double_t *rec = fRec + 4*fIev;
+  vgen.SetPxPyPzE(rec[0], rec[1], rec[2], rec[3]);
+
+  fIev++;
+
+  return true;
+
+}//Next
+
+//_____________________________________________________________________________
+void TInputCache::Close() {
+
+  if( fMap ) munmap(fMap, fMapSize);
+
+  fMap = 0x0;
+  fMapSize = 0;
+  fRec = 0x0;
+  fNevt = 0;
+
+}//Close
+
+//_____________________________________________________________________________
+bool TInputCache::Create(const string& name, const string& inp) {
+
+  //cache is written under unique temporary name in the same directory and renamed
+  //when the input is complete, concurrent runs on the same input do not collide
+
+  if( !SourceKey(inp, fHdr) ) return false;
+  fHdr.nev = 0;
+
+  fName = name;
+
+  vector<char> tmpl(fName.begin(), fName.end());
+  const char *sfx = ".XXXXXX";
+  tmpl.insert(tmpl.end(), sfx, sfx+strlen(sfx)+1);
+
+  int fd = mkstemp(&tmpl[0]);
+  if( fd < 0 ) {
+    cout << "TInputCache: can not write " << fName << endl;
+    return false;
+  }
+  fTmpName = &tmpl[0];
+
+  //the same permissions as a cache created by fopen
+  mode_t mask = umask(0);
+  umask(mask);
+  fchmod(fd, 0666 & ~mask);
+
+  fOut = fdopen(fd, "wb");
+  if( !fOut ) {
+    close(fd);
+    unlink(fTmpName.c_str());
+    cout << "TInputCache: can not write " << fName << endl;
+    return false;
+  }
+  setvbuf(fOut, 0x0, _IOFBF, 1<<20);
+
+  fwrite(&fHdr, sizeof(Header), 1, fOut);
+
+  return true;
+
+}//Create
+
+//_____________________________________________________________________________
+void TInputCache::Add(const TLorentzVector& vgen) {
+
+  if( !fOut ) return;
+
+  Double_t rec[4] = {vgen.Px(), vgen.Py(), vgen.Pz(), vgen.E()};
+  fwrite(rec, sizeof(Double_t), 4, fOut);
+
+  fHdr.nev++;
+
+}//Add
+
+//_____________________________________________________________________________
+bool TInputCache::Finish() {
+
+  //number of events to the header, the cache becomes valid
+
+  if( !fOut ) return false;
+
+  fseek(fOut, 0, SEEK_SET);
+  fwrite(&fHdr, sizeof(Header), 1, fOut);
+  bool stat = fclose(fOut) == 0;
+  fOut = 0x0;
+
+  if( !stat or rename(fTmpName.c_str(), fName.c_str()) != 0 ) {
+    unlink(fTmpName.c_str());
+    return false;
+  }
+
+  cout << "TInputCache: " << fHdr.nev << " input events cached in " << fName << endl;
+
+  return true;
+
+}//Finish
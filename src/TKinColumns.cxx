@@ -0,0 +1,185 @@
+
+//C++ headers
+#include <cmath>
+
+//ROOT headers
+#include "TParticle.h"
+#include "TMath.h"
+
+//local headers
+#include "TKinColumns.h"
+
+using namespace std;
+
+//names of observables, also used for bgen_tree branches and in histogram configuration
+static const char *kVarNames[TKinColumns::kNvar] = {"d0pT", "d0eta", "d0phi", "d1pT", "d1eta", "d1phi",
+  "mrec", "pTrec", "pT2rec", "yrec", "d0cosTheta_hx", "d0phi_hx", "d1cosTheta_hx", "d1phi_hx"};
+
+//_____________________________________________________________________________
+TKinColumns::TKinColumns(unsigned int nmax): fNmax(nmax), fN(0) {
+
+  for(int i=0; i<kNcol; i++) fIn[i].resize(fNmax);
+  for(int i=0; i<4; i++) fBoost[i].resize(fNmax);
+  for(int i=0; i<kNvar; i++) fOut[i].resize(fNmax);
+
+}//TKinColumns
+
+//_____________________________________________________________________________
+const char* TKinColumns::GetVarName(int ivar) {
+
+  return kVarNames[ivar];
+
+}//GetVarName
+
+//_____________________________________________________________________________
+vector<string> TKinColumns::GetVarNames() {
+
+  return vector<string>(kVarNames, kVarNames+kNvar);
+
+}//GetVarNames
+
+//_____________________________________________________________________________
+void TKinColumns::Add(const TParticle *d0, const TParticle *d1) {
+
+  //daughter momenta from generated particles
+
+  fIn[kPx0][fN] = d0->Px();
+  fIn[kPy0][fN] = d0->Py();
+  fIn[kPz0][fN] = d0->Pz();
+  fIn[kE0][fN] = d0->Energy();
+
+  fIn[kPx1][fN] = d1->Px();
+  fIn[kPy1][fN] = d1->Py();
+  fIn[kPz1][fN] = d1->Pz();
+  fIn[kE1][fN] = d1->Energy();
+
+  fN++;
+
+}//Add
+
+//_____________________________________________________________________________
+void TKinColumns::AddPtEtaPhi(const Double_t *d0, const Double_t *d1, Double_t mass) {
+
+  //daughter momenta from pT, eta and phi as stored in bgen_tree
+
+  const Double_t *dv[2] = {d0, d1};
+
+  for(int i=0; i<2; i++) {
+    Double_t px = dv[i][0]*cos(dv[i][2]);
+    Double_t py = dv[i][0]*sin(dv[i][2]);
+    Double_t pz = dv[i][0]*sinh(dv[i][1]);
+
+    fIn[kPx0+4*i][fN] = px;
+    fIn[kPy0+4*i][fN] = py;
+    fIn[kPz0+4*i][fN] = pz;
+    fIn[kE0+4*i][fN] = sqrt(px*px + py*py + pz*pz + mass*mass);
+  }
+
+  fN++;
+
+}//AddPtEtaPhi
+
+//_____________________________________________________________________________
+void TKinColumns::Compute() {
+
+  //all observables for the current batch, column by column
+
+  const unsigned int n = fN;
+
+  //daughters in the laboratory frame
+  PtEtaPhi(n, &fIn[kPx0][0], &fIn[kPy0][0], &fIn[kPz0][0], &fOut[kD0pT][0], &fOut[kD0eta][0], &fOut[kD0phi][0]);
+  PtEtaPhi(n, &fIn[kPx1][0], &fIn[kPy1][0], &fIn[kPz1][0], &fOut[kD1pT][0], &fOut[kD1eta][0], &fOut[kD1phi][0]);
+
+  const Double_t *px0 = &fIn[kPx0][0], *py0 = &fIn[kPy0][0], *pz0 = &fIn[kPz0][0], *e0 = &fIn[kE0][0];
+  const Double_t *px1 = &fIn[kPx1][0], *py1 = &fIn[kPy1][0], *pz1 = &fIn[kPz1][0], *e1 = &fIn[kE1][0];
+
+  Double_t *bx = &fBoost[0][0], *by = &fBoost[1][0], *bz = &fBoost[2][0], *gam = &fBoost[3][0];
+  Double_t *mrec = &fOut[kMrec][0], *ptrec = &fOut[kPTrec][0], *pt2rec = &fOut[kPT2rec][0];
+  Double_t *yrec = &fOut[kYrec][0];
+
+  //dilepton mass, pT and rapidity, boost to its rest frame
+#pragma omp simd
+  for(unsigned int i=0; i<n; i++) {
+
+    Double_t px = px0[i] + px1[i];
+    Double_t py = py0[i] + py1[i];
+    Double_t pz = pz0[i] + pz1[i];
+    Double_t e = e0[i] + e1[i];
+
+    Double_t m2 = e*e - px*px - py*py - pz*pz;
+    mrec[i] = m2 < 0 ? -sqrt(-m2) : sqrt(m2);
+
+    pt2rec[i] = px*px + py*py;
+    ptrec[i] = sqrt(pt2rec[i]);
+
+    yrec[i] = 0.5*log((e + pz)/(e - pz));
+
+    //boost vector from the laboratory to the rest frame
+    bx[i] = -px/e;
+    by[i] = -py/e;
+    bz[i] = -pz/e;
+    gam[i] = 1./sqrt(1. - bx[i]*bx[i] - by[i]*by[i] - bz[i]*bz[i]);
+  }
+
+  //daughter angles in the rest frame relative to laboratory axes
+  RestAngles(n, px0, py0, pz0, e0, bx, by, bz, gam, &fOut[kD0cosTheta][0], &fOut[kD0phiHx][0]);
+  RestAngles(n, px1, py1, pz1, e1, bx, by, bz, gam, &fOut[kD1cosTheta][0], &fOut[kD1phiHx][0]);
+
+}//Compute
+
+//_____________________________________________________________________________
+void TKinColumns::GetRow(unsigned int i, Double_t *val) const {
+
+  for(int ivar=0; ivar<kNvar; ivar++) val[ivar] = fOut[ivar][i];
+
+}//GetRow
+
+//_____________________________________________________________________________
+void TKinColumns::PtEtaPhi(unsigned int n, const Double_t *px, const Double_t *py, const Double_t *pz,
+  Double_t *pt, Double_t *eta, Double_t *phi) {
+
+  //the same conventions as TParticle::Pt, Eta and Phi
+
+#pragma omp simd
+  for(unsigned int i=0; i<n; i++) {
+    pt[i] = sqrt(px[i]*px[i] + py[i]*py[i]);
+  }
+
+#pragma omp simd
+  for(unsigned int i=0; i<n; i++) {
+    Double_t p = sqrt(pt[i]*pt[i] + pz[i]*pz[i]);
+    eta[i] = 0.5*log((p + pz[i])/(p - pz[i]));
+  }
+
+#pragma omp simd
+  for(unsigned int i=0; i<n; i++) {
+    phi[i] = TMath::Pi() + atan2(-py[i], -px[i]);
+  }
+
+}//PtEtaPhi
+
+//_____________________________________________________________________________
+void TKinColumns::RestAngles(unsigned int n, const Double_t *px, const Double_t *py, const Double_t *pz,
+  const Double_t *e, const Double_t *bx, const Double_t *by, const Double_t *bz, const Double_t *gam,
+  Double_t *cth, Double_t *phi) {
+
+  //boost as in TLorentzVector::Boost, cos(theta) and phi of the boosted momentum
+
+#pragma omp simd
+  for(unsigned int i=0; i<n; i++) {
+
+    Double_t b2 = bx[i]*bx[i] + by[i]*by[i] + bz[i]*bz[i];
+    Double_t bp = bx[i]*px[i] + by[i]*py[i] + bz[i]*pz[i];
+    Double_t gam2 = b2 > 0 ? (gam[i] - 1.)/b2 : 0.;
+    Double_t fac = gam2*bp + gam[i]*e[i];
+
+    Double_t x = px[i] + fac*bx[i];
+    Double_t y = py[i] + fac*by[i];
+    Double_t z = pz[i] + fac*bz[i];
+
+    Double_t mag = sqrt(x*x + y*y + z*z);
+    cth[i] = mag > 0 ? z/mag : 1.;
+    phi[i] = atan2(y, x);
+  }
+
+}//RestAngles
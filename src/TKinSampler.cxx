@@ -0,0 +1,240 @@
+
+//C++ headers
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+
+//ROOT headers
+#include "TH2.h"
+#include "TRandom3.h"
+#include "TMath.h"
+
+//local headers
+#include "TKinSampler.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+TKinSampler::TKinSampler(Int_t npt, Double_t ptmin, Double_t ptmax, Int_t ny, Double_t ymin, Double_t ymax):
+  fNfill(0) {
+
+  fNbins[0] = npt;
+  fNbins[1] = ny;
+  fMin[0] = ptmin;
+  fMin[1] = ymin;
+  fMax[0] = ptmax;
+  fMax[1] = ymax;
+
+  for(int i=0; i<2; i++) fWidth[i] = (fMax[i]-fMin[i])/fNbins[i];
+
+  fSumw.assign(fNbins[0]*fNbins[1], 0);
+
+}//TKinSampler
+
+//_____________________________________________________________________________
+void TKinSampler::Fill(Double_t pt, Double_t y, Double_t w) {
+
+  //parents outside the ranges are not sampled
+
+  int ipt = int( (pt-fMin[0])/fWidth[0] );
+  int iy = int( (y-fMin[1])/fWidth[1] );
+
+  if( pt < fMin[0] or ipt >= fNbins[0] ) return;
+  if( y < fMin[1] or iy >= fNbins[1] ) return;
+
+  fSumw[ipt + fNbins[0]*iy] += w;
+  fNfill += w;
+
+}//Fill
+
+//_____________________________________________________________________________
+bool TKinSampler::FromHist(const TH2 *hx) {
+
+  //spectrum from histogram with pT on x and y on y axis, uniform binning is assumed
+
+  TH2 *hc = const_cast<TH2*>(hx);
+
+  fNbins[0] = hc->GetXaxis()->GetNbins();
+  fNbins[1] = hc->GetYaxis()->GetNbins();
+  fMin[0] = hc->GetXaxis()->GetXmin();
+  fMin[1] = hc->GetYaxis()->GetXmin();
+  fMax[0] = hc->GetXaxis()->GetXmax();
+  fMax[1] = hc->GetYaxis()->GetXmax();
+
+  for(int i=0; i<2; i++) fWidth[i] = (fMax[i]-fMin[i])/fNbins[i];
+
+  fSumw.assign(fNbins[0]*fNbins[1], 0);
+  fNfill = 0;
+
+  for(int iy=0; iy<fNbins[1]; iy++) {
+    for(int ipt=0; ipt<fNbins[0]; ipt++) {
+      Double_t val = hx->GetBinContent(ipt+1, iy+1);
+      if( val <= 0 ) continue;
+      fSumw[ipt + fNbins[0]*iy] = val;
+      fNfill += val;
+    }
+  }
+
+  return Build();
+
+}//FromHist
+
+//_____________________________________________________________________________
+bool TKinSampler::Build() {
+
+  //alias table by Vose's method
+
+  unsigned long ncell = fSumw.size();
+  if( fNfill <= 0 ) {
+    cout << "TKinSampler: empty spectrum" << endl;
+    return false;
+  }
+
+  //probabilities scaled to the mean of one
+  vector<Double_t> scaled(ncell);
+  vector<UInt_t> small, large;
+  for(unsigned long i=0; i<ncell; i++) {
+    scaled[i] = fSumw[i]*ncell/fNfill;
+    if( scaled[i] < 1 ) {
+      small.push_back(i);
+    } else {
+      large.push_back(i);
+    }
+  }
+
+  fProb.assign(ncell, 1);
+  fAlias.resize(ncell);
+  for(unsigned long i=0; i<ncell; i++) fAlias[i] = i;
+
+  //each small cell is completed by a part of large cell
+  while( !small.empty() and !large.empty() ) {
+
+    UInt_t is = small.back();
+    small.pop_back();
+    UInt_t il = large.back();
+
+    fProb[is] = scaled[is];
+    fAlias[is] = il;
+
+    scaled[il] -= 1. - scaled[is];
+    if( scaled[il] < 1 ) {
+      large.pop_back();
+      small.push_back(il);
+    }
+  }
+
+  //remaining cells are complete up to rounding
+  for(unsigned long i=0; i<small.size(); i++) fProb[small[i]] = 1;
+  for(unsigned long i=0; i<large.size(); i++) fProb[large[i]] = 1;
+
+  return true;
+
+}//Build
+
+//_____________________________________________________________________________
+bool TKinSampler::Save(const string& name) const {
+
+  //binary spectrum: tag, bins and ranges, sum of weights in each cell
+
+  ofstream out(name.c_str(), ios::binary);
+  if( !out.is_open() ) {
+    cout << "TKinSampler: can not write " << name << endl;
+    return false;
+  }
+
+  out.write("TKINSMP1", 8);
+  out.write(reinterpret_cast<const char*>(fNbins), sizeof(fNbins));
+  out.write(reinterpret_cast<const char*>(fMin), sizeof(fMin));
+  out.write(reinterpret_cast<const char*>(fMax), sizeof(fMax));
+  out.write(reinterpret_cast<const char*>(&fSumw[0]), fSumw.size()*sizeof(Double_t));
+
+  return out.good();
+
+}//Save
+
+//_____________________________________________________________________________
+bool TKinSampler::Load(const string& name) {
+
+  //spectrum written by Save, alias table is built after loading
+
+  ifstream in(name.c_str(), ios::binary);
+  if( !in.is_open() ) {
+    cout << "TKinSampler: can not open " << name << endl;
+    return false;
+  }
+
+  char tag[8];
+  in.read(tag, 8);
+  if( !in.good() or memcmp(tag, "TKINSMP1", 8) != 0 ) {
+    cout << "TKinSampler: " << name << " is not a kinematics sampler" << endl;
+    return false;
+  }
+
+  in.read(reinterpret_cast<char*>(fNbins), sizeof(fNbins));
+  in.read(reinterpret_cast<char*>(fMin), sizeof(fMin));
+  in.read(reinterpret_cast<char*>(fMax), sizeof(fMax));
+
+  //binning is checked before the allocation, limit of 2^28 cells
+  unsigned long ncell = 1;
+  for(int i=0; i<2; i++) {
+    if( !in.good() or fNbins[i] < 1 or !(fMax[i] > fMin[i]) or ncell*fNbins[i] > (1ul<<28) ) {
+      cout << "TKinSampler: " << name << " has invalid binning" << endl;
+      return false;
+    }
+    ncell *= fNbins[i];
+  }
+
+  for(int i=0; i<2; i++) fWidth[i] = (fMax[i]-fMin[i])/fNbins[i];
+
+  fSumw.resize(ncell);
+  in.read(reinterpret_cast<char*>(&fSumw[0]), fSumw.size()*sizeof(Double_t));
+
+  if( !in.good() ) {
+    cout << "TKinSampler: " << name << " is truncated" << endl;
+    return false;
+  }
+
+  fNfill = 0;
+  for(unsigned long i=0; i<fSumw.size(); i++) fNfill += fSumw[i];
+
+  return Build();
+
+}//Load
+
+//_____________________________________________________________________________
+void TKinSampler::Generate(TRandom3& rnd, Double_t mass, unsigned int n, Double_t *p4) const {
+
+  //n parents as px, py, pz and energy in p4, four random numbers per parent
+
+  vector<Double_t> rn(4*n);
+  rnd.RndmArray(4*n, &rn[0]);
+
+  unsigned long ncell = fProb.size();
+  Double_t m2 = mass*mass;
+
+  for(unsigned int i=0; i<n; i++) {
+
+    const Double_t *u = &rn[4*i];
+
+    //cell from the alias table
+    unsigned long icell = (unsigned long)(u[0]*ncell);
+    if( icell >= ncell ) icell = ncell-1;
+    Double_t frac = u[0]*ncell - icell; // reused uniform for the alias decision
+    if( frac >= fProb[icell] ) icell = fAlias[icell];
+
+    //uniform within the cell and in azimuth
+    Double_t pt = fMin[0] + (icell % fNbins[0] + u[1])*fWidth[0];
+    Double_t y = fMin[1] + (icell / fNbins[0] + u[2])*fWidth[1];
+    Double_t phi = 2.*TMath::Pi()*u[3];
+
+    Double_t mt = sqrt(m2 + pt*pt);
+
+    Double_t *p = p4 + 4*i;
+    p[0] = pt*cos(phi);
+    p[1] = pt*sin(phi);
+    p[2] = mt*sinh(y);
+    p[3] = mt*cosh(y);
+  }
+
+}//Generate
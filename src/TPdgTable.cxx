@@ -0,0 +1,121 @@
+
+//C++ headers
+#include <cstdlib>
+
+//ROOT headers
+#include "TDatabasePDG.h"
+#include "TParticlePDG.h"
+
+//local headers
+#include "TPdgTable.h"
+
+namespace {
+
+//particles from the generators and psi(2S), chi_c and Upsilon decays, PDG masses;
+//Geant3 codes as in TDatabasePDG::ConvertPdgToGeant3, 0 for codes without Geant3 equivalent
+constexpr TPdgTable::Entry kTable[] = {
+  {22, 0., 0, 1, 1, "gamma"},
+  {11, 0.00051099895, -1, 3, 2, "e-"},
+  {13, 0.1056583755, -1, 6, 5, "mu-"},
+  {15, 1.77686, -1, 34, 33, "tau-"},
+  {111, 0.1349768, 0, 7, 7, "pi0"},
+  {211, 0.13957039, 1, 8, 9, "pi+"},
+  {130, 0.497611, 0, 10, 10, "K0L"},
+  {310, 0.497611, 0, 16, 16, "K0S"},
+  {321, 0.493677, 1, 11, 12, "K+"},
+  {221, 0.547862, 0, 17, 17, "eta"},
+  {113, 0.77526, 0, 0, 0, "rho0"},
+  {223, 0.78266, 0, 0, 0, "omega"},
+  {331, 0.95778, 0, 0, 0, "eta'"},
+  {333, 1.019461, 0, 0, 0, "phi"},
+  {2112, 0.93956542052, 0, 13, 25, "n"},
+  {2212, 0.93827208816, 1, 14, 15, "p"},
+  {3122, 1.115683, 0, 18, 26, "Lambda"},
+  {441, 2.9839, 0, 0, 0, "eta_c"},
+  {443, 3.0969, 0, 0, 0, "J/psi"},
+  {10441, 3.41471, 0, 0, 0, "chi_c0"},
+  {20443, 3.51067, 0, 0, 0, "chi_c1"},
+  {445, 3.55617, 0, 0, 0, "chi_c2"},
+  {10443, 3.52538, 0, 0, 0, "h_c"},
+  {100443, 3.686097, 0, 0, 0, "psi(2S)"},
+  {553, 9.4603, 0, 0, 0, "Upsilon"},
+  {100553, 10.02326, 0, 0, 0, "Upsilon(2S)"},
+  {200553, 10.3552, 0, 0, 0, "Upsilon(3S)"},
+  {10551, 9.8594, 0, 0, 0, "chi_b0"},
+  {20553, 9.89278, 0, 0, 0, "chi_b1"},
+  {555, 9.91221, 0, 0, 0, "chi_b2"}
+};
+
+constexpr int kNentries = sizeof(kTable)/sizeof(kTable[0]);
+
+//dense index, hash of |pdg| to position in kTable with linear probing
+constexpr int kNslots = 128;
+
+inline unsigned int Slot(unsigned int apdg) { return (apdg*2654435761u) >> 25; }
+
+struct Index {
+
+  short fSlot[kNslots]; // position in kTable or -1 for empty slot
+
+  Index() {
+    for(int i=0; i<kNslots; i++) fSlot[i] = -1;
+    for(int i=0; i<kNentries; i++) {
+      unsigned int is = Slot( kTable[i].pdg );
+      while( fSlot[is] >= 0 ) is = (is+1) % kNslots;
+      fSlot[is] = i;
+    }
+  }
+
+};//Index
+
+}
+
+//_____________________________________________________________________________
+const TPdgTable::Entry* TPdgTable::Find(Int_t pdg) {
+
+  //table entry for the particle or antiparticle, null for unknown code
+
+  static const Index idx;
+
+  unsigned int apdg = std::abs(pdg);
+
+  for(unsigned int is = Slot(apdg); idx.fSlot[is] >= 0; is = (is+1) % kNslots) {
+    const Entry& ent = kTable[ idx.fSlot[is] ];
+    if( (unsigned int)ent.pdg == apdg ) return &ent;
+  }
+
+  return 0x0;
+
+}//Find
+
+//_____________________________________________________________________________
+Double_t TPdgTable::Mass(Int_t pdg) {
+
+  const Entry *ent = Find(pdg);
+  if( ent ) return ent->mass;
+
+  return TDatabasePDG::Instance()->GetParticle(pdg)->Mass();
+
+}//Mass
+
+//_____________________________________________________________________________
+Double_t TPdgTable::Charge(Int_t pdg) {
+
+  const Entry *ent = Find(pdg);
+  if( ent ) return pdg > 0 ? ent->charge : -ent->charge;
+
+  //ROOT charge is in units of |e|/3
+  return TDatabasePDG::Instance()->GetParticle(pdg)->Charge()/3.;
+
+}//Charge
+
+//_____________________________________________________________________________
+Int_t TPdgTable::Geant3(Int_t pdg) {
+
+  const Entry *ent = Find(pdg);
+  if( ent ) return pdg > 0 ? ent->g3 : ent->g3bar;
+
+  return TDatabasePDG::Instance()->ConvertPdgToGeant3(pdg);
+
+}//Geant3
+
@@ -0,0 +1,183 @@
+
+//C++ headers
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+//ROOT headers
+#include "TLorentzVector.h"
+#include "TMath.h"
+
+//local headers
+#include "TPolWeights.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+TPolWeights::TPolWeights(Double_t alpha): fAlpha(alpha), fFrame(kHelicity), fCosTheta(0), fPhi(0) {
+
+  //PbPb at 5.02 TeV
+  SetBeamEnergy(2510.);
+
+}//TPolWeights
+
+//_____________________________________________________________________________
+bool TPolWeights::SetBeamEnergy(Double_t ebeam) {
+
+  //beam energy per nucleon, defines the beam axes in Collins-Soper frame,
+  //false for energy not above the nucleon mass
+
+  Double_t mnuc = 0.938272;
+
+  if( !(ebeam > mnuc) ) {
+    cout << "TPolWeights: invalid beam energy " << ebeam << endl;
+    return false;
+  }
+
+  fEbeam = ebeam;
+  fPbeam = TMath::Sqrt((ebeam + mnuc)*(ebeam - mnuc));
+
+  return true;
+
+}//SetBeamEnergy
+
+//_____________________________________________________________________________
+void TPolWeights::AddHypothesis(Double_t lth, Double_t lph, Double_t ltp) {
+
+  fLth.push_back(lth);
+  fLph.push_back(lph);
+  fLtp.push_back(ltp);
+
+  fW.resize( fLth.size() );
+
+}//AddHypothesis
+
+//_____________________________________________________________________________
+bool TPolWeights::LoadConfig(const string& cfg) {
+
+  //hypotheses from configuration file, one hypothesis per line:
+  //
+  //  lambda_theta lambda_phi lambda_theta_phi
+  //
+  //optional lines 'frame hx' or 'frame cs' and 'ebeam <energy per nucleon>',
+  //lines starting with '#' are comments
+
+  ifstream in(cfg.c_str());
+  if( !in.is_open() ) {
+    cout << "TPolWeights: can not open " << cfg << endl;
+    return false;
+  }
+
+  string line;
+  while( getline(in, line) ) {
+
+    istringstream ss(line);
+
+    string key;
+    if( !(ss >> key) or key[0] == '#' ) continue;
+
+    if( key == "frame" ) {
+      string frame;
+      ss >> frame;
+      if( frame == "hx" ) {
+        fFrame = kHelicity;
+      } else if( frame == "cs" ) {
+        fFrame = kCollinsSoper;
+      } else {
+        cout << "TPolWeights: unknown frame " << frame << endl;
+        return false;
+      }
+      continue;
+    }
+
+    if( key == "ebeam" ) {
+      Double_t ebeam = 0;
+      if( !(ss >> ebeam) or !SetBeamEnergy(ebeam) ) {
+        cout << "TPolWeights: invalid line in " << cfg << ": " << line << endl;
+        return false;
+      }
+      continue;
+    }
+
+    ss.clear();
+    ss.str(line);
+
+    Double_t lth, lph, ltp;
+    if( !(ss >> lth >> lph >> ltp) ) {
+      cout << "TPolWeights: invalid line in " << cfg << ": " << line << endl;
+      return false;
+    }
+
+    AddHypothesis(lth, lph, ltp);
+  }
+
+  return true;
+
+}//LoadConfig
+
+//_____________________________________________________________________________
+void TPolWeights::Compute(const TLorentzVector& vm, const TLorentzVector& lep) {
+
+  //decay angles and weights for all hypotheses, lep is the positive lepton
+
+  Angles(vm, lep, fFrame, fCosTheta, fPhi);
+
+  //generated distribution, normalized 1 + alpha*cos^2(theta) in helicity frame
+  Double_t cthx = fCosTheta;
+  if( fFrame != kHelicity ) {
+    Double_t phx;
+    Angles(vm, lep, kHelicity, cthx, phx);
+  }
+  Double_t wgen = (3. + fAlpha)/(1. + fAlpha*cthx*cthx);
+
+  Double_t cos2 = fCosTheta*fCosTheta;
+  Double_t sin2 = 1. - cos2;
+  Double_t sin2th = 2.*fCosTheta*TMath::Sqrt(sin2);
+
+  for(unsigned int i=0; i<fW.size(); i++) {
+
+    Double_t wpol = 1. + fLth[i]*cos2 + fLph[i]*sin2*TMath::Cos(2.*fPhi) + fLtp[i]*sin2th*TMath::Cos(fPhi);
+
+    fW[i] = wgen * wpol/(3. + fLth[i]);
+  }
+
+}//Compute
+
+//_____________________________________________________________________________
+void TPolWeights::Angles(const TLorentzVector& vm, const TLorentzVector& lep, EFrame frame,
+  Double_t& costh, Double_t& phi) const {
+
+  //polar and azimuthal angle of the lepton in vector meson rest frame,
+  //y axis is normal to the plane of the beams, helicity z axis is along
+  //the vector meson momentum and Collins-Soper z axis bisects the beams
+
+  TVector3 beta = -vm.BoostVector();
+
+  TLorentzVector b1(0, 0, fPbeam, fEbeam);
+  TLorentzVector b2(0, 0, -fPbeam, fEbeam);
+  TLorentzVector lv = lep;
+
+  b1.Boost(beta);
+  b2.Boost(beta);
+  lv.Boost(beta);
+
+  TVector3 p1 = b1.Vect();
+  TVector3 p2 = b2.Vect();
+
+  TVector3 zax;
+  if( frame == kHelicity ) {
+    zax = (-(p1 + p2)).Unit();
+  } else {
+    zax = (p1.Unit() - p2.Unit()).Unit();
+  }
+
+  TVector3 yax = (p1.Cross(p2)).Unit();
+  TVector3 xax = (yax.Cross(zax)).Unit();
+
+  TVector3 pl = lv.Vect();
+
+  costh = pl.Dot(zax)/pl.Mag();
+  phi = TMath::ATan2(pl.Dot(yax), pl.Dot(xax));
+
+}//Angles
+
@@ -0,0 +1,110 @@
+
+//C++ headers
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+//local headers
+#include "TTxIndex.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+bool TTxIndex::Create(const string& name) {
+
+  //binary index: tag followed by fixed size records
+
+  fOut.open(name.c_str(), ios::binary);
+  if( !fOut.is_open() ) {
+    cout << "TTxIndex: can not write " << name << endl;
+    return false;
+  }
+
+  fOut.write("TTXIDX01", 8);
+
+  fRec.clear();
+  fRec.reserve(1<<14);
+
+  return true;
+
+}//Create
+
+//_____________________________________________________________________________
+void TTxIndex::Add(ULong64_t ntx, ULong64_t offset, Double_t y, Double_t pt) {
+
+  Record rec;
+  rec.ntx = ntx;
+  rec.offset = offset;
+  rec.y = y;
+  rec.pt = pt;
+
+  fRec.push_back(rec);
+
+  //records are written in blocks
+  if( fRec.size() >= (1<<14) ) {
+    fOut.write(reinterpret_cast<const char*>(&fRec[0]), fRec.size()*sizeof(Record));
+    fRec.clear();
+  }
+
+}//Add
+
+//_____________________________________________________________________________
+void TTxIndex::Close() {
+
+  if( !fOut.is_open() ) return;
+
+  if( !fRec.empty() ) fOut.write(reinterpret_cast<const char*>(&fRec[0]), fRec.size()*sizeof(Record));
+  fRec.clear();
+
+  fOut.close();
+
+}//Close
+
+//_____________________________________________________________________________
+bool TTxIndex::Load(const string& name) {
+
+  ifstream in(name.c_str(), ios::binary | ios::ate);
+  if( !in.is_open() ) {
+    cout << "TTxIndex: can not open " << name << endl;
+    return false;
+  }
+
+  streamoff size = in.tellg();
+  in.seekg(0);
+
+  char tag[8];
+  in.read(tag, 8);
+  if( !in.good() or memcmp(tag, "TTXIDX01", 8) != 0 ) {
+    cout << "TTxIndex: " << name << " is not a .tx index" << endl;
+    return false;
+  }
+
+  //incomplete last record from interrupted writing is ignored
+  fRec.resize( (size-8)/sizeof(Record) );
+  if( !fRec.empty() ) in.read(reinterpret_cast<char*>(&fRec[0]), fRec.size()*sizeof(Record));
+
+  if( !in.good() ) {
+    cout << "TTxIndex: " << name << " is truncated" << endl;
+    return false;
+  }
+
+  return true;
+
+}//Load
+
+//_____________________________________________________________________________
+long TTxIndex::Find(ULong64_t ntx) const {
+
+  //position of the event in the index, records are ordered in event number, -1 when not present
+
+  Record rec;
+  rec.ntx = ntx;
+
+  vector<Record>::const_iterator it = lower_bound(fRec.begin(), fRec.end(), rec,
+    [](const Record& a, const Record& b) { return a.ntx < b.ntx; });
+
+  if( it == fRec.end() or it->ntx != ntx ) return -1;
+
+  return it - fRec.begin();
+
+}//Find
@@ -0,0 +1,173 @@
+
+//C++ headers
+#include <iostream>
+#include <iomanip>
+
+//ROOT headers
+#include "TH1D.h"
+#include "TTree.h"
+#include "TDirectory.h"
+#include "TLorentzVector.h"
+
+//local headers
+#include "TValidator.h"
+#include "TEventBatch.h"
+#include "TPolWeights.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+TValidator::TValidator(): fTime(0), fNevt(0) {
+
+  fAngles = new TPolWeights();
+
+  Book();
+
+}//TValidator
+
+//_____________________________________________________________________________
+TValidator::~TValidator() {
+
+  for(unsigned int i=0; i<fHist.size(); i++) delete fHist[i];
+
+  delete fAngles;
+
+}//~TValidator
+
+//_____________________________________________________________________________
+void TValidator::Book() {
+
+  //distributions, not attached to any ROOT directory
+
+  Bool_t adddir = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(kFALSE);
+
+  fHist.push_back( new TH1D("valPt", "dilepton p_{T}", 100, 0, 1) );
+  fHist.push_back( new TH1D("valY", "dilepton y", 100, -6, 6) );
+  fHist.push_back( new TH1D("valM", "dilepton mass", 100, 2.9, 3.3) );
+  fHist.push_back( new TH1D("valCosTheta", "cos#theta_{HX}", 50, -1, 1) );
+  fHist.push_back( new TH1D("valPhi", "#phi_{HX}", 50, -TMath::Pi(), TMath::Pi()) );
+  fHist.push_back( new TH1D("valMult", "particles per event", 12, -0.5, 11.5) );
+
+  for(unsigned int i=0; i<fHist.size(); i++) fHist[i]->Sumw2();
+
+  TH1::AddDirectory(adddir);
+
+}//Book
+
+//_____________________________________________________________________________
+void TValidator::Fill(const TEventBatch& batch) {
+
+  //the first two particles in each event are the dilepton
+
+  for(TEventBatch::const_iterator it = batch.begin(); it != batch.end(); ++it) {
+
+    TEventView ev = *it;
+    Double_t w = ev.Weight();
+
+    TLorentzVector l0(ev.Px(0), ev.Py(0), ev.Pz(0), ev.E(0));
+    TLorentzVector l1(ev.Px(1), ev.Py(1), ev.Pz(1), ev.E(1));
+    TLorentzVector vm = l0 + l1;
+
+    fHist[0]->Fill(vm.Pt(), w);
+    fHist[1]->Fill(vm.Rapidity(), w);
+    fHist[2]->Fill(vm.M(), w);
+
+    //angles of the positive lepton
+    Double_t costh, phi;
+    fAngles->Angles(vm, ev.Pdg(0) < 0 ? l0 : l1, TPolWeights::kHelicity, costh, phi);
+    fHist[3]->Fill(costh, w);
+    fHist[4]->Fill(phi, w);
+
+    fHist[5]->Fill(ev.GetNParticles(), w);
+  }
+
+}//Fill
+
+//_____________________________________________________________________________
+void TValidator::Write() const {
+
+  //distributions and timing to the current directory
+
+  for(unsigned int i=0; i<fHist.size(); i++) fHist[i]->Write();
+
+  Double_t rtime = fTime;
+  ULong64_t nev = fNevt;
+  TTree valInfo("valInfo", "valInfo");
+  valInfo.Branch("rtime", &rtime, "rtime/D");
+  valInfo.Branch("nev", &nev, "nev/l");
+  valInfo.Fill();
+  valInfo.Write();
+
+}//Write
+
+//_____________________________________________________________________________
+bool TValidator::Load(TDirectory *dir) {
+
+  //distributions and timing written by Write
+
+  for(unsigned int i=0; i<fHist.size(); i++) {
+
+    TH1D *hx = 0x0;
+    dir->GetObject(fHist[i]->GetName(), hx);
+    if( !hx ) {
+      cout << "TValidator: missing " << fHist[i]->GetName() << endl;
+      return false;
+    }
+    hx->SetDirectory(0);
+
+    delete fHist[i];
+    fHist[i] = hx;
+  }
+
+  TTree *valInfo = 0x0;
+  dir->GetObject("valInfo", valInfo);
+  if( !valInfo ) return false;
+
+  ULong64_t nev = 0;
+  valInfo->SetBranchAddress("rtime", &fTime);
+  valInfo->SetBranchAddress("nev", &nev);
+  valInfo->GetEntry(0);
+  fNevt = nev;
+
+  return true;
+
+}//Load
+
+//_____________________________________________________________________________
+bool TValidator::Compare(const TValidator& ref, const TValidator& cand, Double_t pmin) {
+
+  //chi2 and Kolmogorov-Smirnov test for each distribution, the candidate
+  //fails when any p-value is below pmin
+
+  bool pass = true;
+
+  cout << setw(14) << left << "distribution" << right << setw(12) << "chi2 p" << setw(12) << "KS p" << endl;
+
+  for(unsigned int i=0; i<ref.fHist.size(); i++) {
+
+    Double_t pchi2 = ref.fHist[i]->Chi2Test(cand.fHist[i], "WW");
+    Double_t pks = ref.fHist[i]->KolmogorovTest(cand.fHist[i]);
+
+    bool ok = pchi2 >= pmin and pks >= pmin;
+    if( !ok ) pass = false;
+
+    cout << setw(14) << left << ref.fHist[i]->GetName() << right;
+    cout << setw(12) << pchi2 << setw(12) << pks;
+    cout << (ok ? "" : "  DIFFERENT") << endl;
+  }
+
+  //events per second for both paths
+  Double_t rref = ref.fTime > 0 ? ref.fNevt/ref.fTime : 0;
+  Double_t rcand = cand.fTime > 0 ? cand.fNevt/cand.fTime : 0;
+
+  cout << "reference: " << ref.fNevt << " events in " << ref.fTime << " s" << endl;
+  cout << "candidate: " << cand.fNevt << " events in " << cand.fTime << " s" << endl;
+  if( rref > 0 ) cout << "speedup: " << rcand/rref << endl;
+
+  cout << (pass ? "candidate is compatible with reference" : "candidate differs from reference") << endl;
+
+  return pass;
+
+}//Compare
+
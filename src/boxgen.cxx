@@ -1,50 +1,88 @@
 
 //C++ headers
 #include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <cstdlib>
 
 //ROOT headers
 #include "TClonesArray.h"
 #include "TParticle.h"
 #include "TFile.h"
 #include "TTree.h"
+#include "TROOT.h"
+#include "TList.h"
+#include "TParameter.h"
 
 //local headers
 #include "TGenUPCJpsiFlat.h"
+#include "THistAccum.h"
+#include "TAccMap.h"
+#include "TKinColumns.h"
+#include "TPdgTable.h"
 
 using namespace std;
 
+//derived variables, computed in batches by TKinColumns, the same names are used
+//for bgen_tree branches and in histogram configuration
+const int nvar = TKinColumns::kNvar;
+
+TTree* MakeTree(Double_t *val, int pdg);
+void FillTree(TKinColumns& kin, TTree *tree, Double_t *val);
+int HistMode(const string& cfg, int nev, unsigned int nthr);
+int AccMode(const string& mapname, int nev, unsigned int nthr);
+int PostMode(const string& inp, const string& outp, int pdg);
+
 //_____________________________________________________________________________
 int main(int argc, char* argv[]) {
 
+  //Int_t nev = 120;
+  int nev = 6e6;
+
+  //derived variables from existing output: ./boxgen -post output.root post.root [lepton pdg]
+  if(argc > 3 and string(argv[1]) == "-post") {
+    int pdg = 0;
+    if(argc > 4) pdg = atoi(argv[4]);
+
+    return PostMode(argv[2], argv[3], pdg);
+  }
+
+  //acceptance map: ./boxgen -acc acc.map [nthreads]
+  if(argc > 2 and string(argv[1]) == "-acc") {
+    unsigned int nthr = 1;
+    if(argc > 3) nthr = atoi(argv[3]);
+    if(nthr < 1) nthr = 1;
+
+    return AccMode(argv[2], nev, nthr);
+  }
+
+  //histogram mode: ./boxgen hist.cfg [nthreads], per-event tree otherwise
+  if(argc > 1 and string(argv[1]) != "-cuts") {
+    unsigned int nthr = 1;
+    if(argc > 2) nthr = atoi(argv[2]);
+    if(nthr < 1) nthr = 1;
+
+    return HistMode(argv[1], nev, nthr);
+  }
+
   //configure the generator
   //TGenUPCJpsiFlat gen(0.14, -1.2, 1.2); // max pT^2 and eta range
   TGenUPCJpsiFlat gen(0.01, -1.2, 1.2); // max pT^2 and eta range
   TClonesArray *particles = new TClonesArray("TParticle");
 
-  //Int_t nev = 120;
-  int nev = 6e6;
+  //selection in generating loop: ./boxgen -cuts cuts.cfg
+  if(argc > 2 and !gen.SetCuts(argv[2])) return -1;
+
   int nprint = nev/12;
 
   //ROOT output
   TFile *outfile = TFile::Open("output.root", "recreate");
-  Double_t d0pT, d0eta, d0phi, d1pT, d1eta, d1phi;
-  Double_t mrec, pTrec, pT2rec, yrec;
-  Double_t d0cosTheta_hx, d0phi_hx, d1cosTheta_hx, d1phi_hx;
-  TTree *bgen_tree = new TTree("bgen_tree", "bgen_tree");
-  bgen_tree ->Branch("d0pT", &d0pT, "d0pT/D");
-  bgen_tree ->Branch("d0eta", &d0eta, "d0eta/D");
-  bgen_tree ->Branch("d0phi", &d0phi, "d0phi/D");
-  bgen_tree ->Branch("d1pT", &d1pT, "d1pT/D");
-  bgen_tree ->Branch("d1eta", &d1eta, "d1eta/D");
-  bgen_tree ->Branch("d1phi", &d1phi, "d1phi/D");
-  bgen_tree ->Branch("mrec", &mrec, "mrec/D");
-  bgen_tree ->Branch("pTrec", &pTrec, "pTrec/D");
-  bgen_tree ->Branch("pT2rec", &pT2rec, "pT2rec/D");
-  bgen_tree ->Branch("yrec", &yrec, "yrec/D");
-  bgen_tree ->Branch("d0cosTheta_hx", &d0cosTheta_hx, "d0cosTheta_hx/D");
-  bgen_tree ->Branch("d0phi_hx", &d0phi_hx, "d0phi_hx/D");
-  bgen_tree ->Branch("d1cosTheta_hx", &d1cosTheta_hx, "d1cosTheta_hx/D");
-  bgen_tree ->Branch("d1phi_hx", &d1phi_hx, "d1phi_hx/D");
+  Double_t val[nvar];
+  TTree *bgen_tree = MakeTree(val, TGenUPCJpsiFlat::kLeptonPdg);
+
+  //decays collected for columnar computation of derived variables
+  TKinColumns kin;
 
   //event loop
   for(int i=0; i<nev; i++) {
@@ -64,61 +102,236 @@ int main(int argc, char* argv[]) {
 
     //cout << vmDaughter0->Eta() << " " << vmDaughter1->Eta() << endl;
 
-    //decay particles in output tree
-    d0pT = vmDaughter0->Pt();
-    d0eta = vmDaughter0->Eta();
-    d0phi = vmDaughter0->Phi();
-    d1pT = vmDaughter1->Pt();
-    d1eta = vmDaughter1->Eta();
-    d1phi = vmDaughter1->Phi();
-
-    //decay particles Lorentz vectors
-    TLorentzVector d0vec, d1vec;
-    vmDaughter0->Momentum(d0vec);
-    vmDaughter1->Momentum(d1vec);
-
-    //verify vector meson reconstruction from the decay
-    TLorentzVector vmrec = d0vec + d1vec;
-    mrec = vmrec.M();
-    pTrec = vmrec.Pt();
-    pT2rec = pTrec*pTrec;
-    yrec = vmrec.Rapidity();
-
-    //angular distribution in J/psi rest frame
-    TVector3 bvec = vmrec.BoostVector();
-    d0vec.Boost(-bvec.x(), -bvec.y(), -bvec.z());
-    d1vec.Boost(-bvec.x(), -bvec.y(), -bvec.z());
-    d0cosTheta_hx = d0vec.CosTheta();
-    d0phi_hx = d0vec.Phi();
-    d1cosTheta_hx = d1vec.CosTheta();
-    d1phi_hx = d1vec.Phi();
-
-    //fill output tree
-    bgen_tree->Fill();
+    //decay particles to the batch, full batch goes to output tree
+    kin.Add(vmDaughter0, vmDaughter1);
+    if( kin.IsFull() ) FillTree(kin, bgen_tree, val);
 
   }//event loop
 
+  //last incomplete batch
+  FillTree(kin, bgen_tree, val);
+
   bgen_tree->Write();
   outfile->Close();
 
+  gen.PrintCuts();
+
   return 0;
 
 }//main
 
+//_____________________________________________________________________________
+TTree* MakeTree(Double_t *val, int pdg) {
+
+  //output tree with branch for each derived variable, daughter pdg in user info
+
+  TTree *tree = new TTree("bgen_tree", "bgen_tree");
+  for(int i=0; i<nvar; i++) {
+    tree ->Branch(TKinColumns::GetVarName(i), &val[i], Form("%s/D", TKinColumns::GetVarName(i)));
+  }
+  tree->GetUserInfo()->Add( new TParameter<Int_t>("leptonPdg", pdg) );
+
+  return tree;
+
+}//MakeTree
+
+//_____________________________________________________________________________
+void FillTree(TKinColumns& kin, TTree *tree, Double_t *val) {
+
+  //derived variables for the batch, one tree entry per decay
 
+  kin.Compute();
 
+  for(unsigned int i=0; i<kin.GetN(); i++) {
+    kin.GetRow(i, val);
+    tree->Fill();
+  }
 
+  kin.Clear();
 
+}//FillTree
 
+//_____________________________________________________________________________
+int HistMode(const string& cfg, int nev, unsigned int nthr) {
+
+  //fill only pre-booked histograms, events are generated in nthr threads,
+  //each with its own generator and histogram accumulator
+
+  THistAccum acc( TKinColumns::GetVarNames() );
+  if( !acc.LoadConfig(cfg) ) return -1;
+  acc.SetNSlots(nthr);
+
+  ROOT::EnableThreadSafety();
 
+  //generators are created sequentially, no .tx output
+  vector<TGenUPCJpsiFlat*> gen(nthr);
+  for(unsigned int ithr=0; ithr<nthr; ithr++) {
+    gen[ithr] = new TGenUPCJpsiFlat(0.01, -1.2, 1.2, ""); // max pT^2 and eta range
+    gen[ithr]->SetSeed(5572323 + 100*ithr);
+  }
 
+  vector<thread> workers;
+  for(unsigned int ithr=0; ithr<nthr; ithr++) {
 
+    int nthrev = nev/int(nthr) + (int(ithr) < nev%int(nthr) ? 1 : 0);
 
+    workers.push_back( thread([&acc, &gen, ithr, nthrev] {
 
+      Double_t val[nvar];
+      TKinColumns kin;
+      for(int i=0; i<=nthrev; i++) {
 
+        //histograms filled from full batch and after the last event
+        if( kin.IsFull() or i == nthrev ) {
+          kin.Compute();
+          for(unsigned int j=0; j<kin.GetN(); j++) {
+            kin.GetRow(j, val);
+            acc.Fill(ithr, val);
+          }
+          kin.Clear();
+        }
+        if( i == nthrev ) break;
 
+        gen[ithr]->GenerateEvent();
+        kin.Add(gen[ithr]->GetParticle(0), gen[ithr]->GetParticle(1));
+      }
 
+    }) );
+  }
 
+  for(unsigned int ithr=0; ithr<nthr; ithr++) {
+    workers[ithr].join();
+    delete gen[ithr];
+  }
+
+  cout << "generated " << nev << " events in " << nthr << " threads" << endl;
+
+  //merged histograms to ROOT output
+  TFile *outfile = TFile::Open("output.root", "recreate");
+  acc.Write();
+  outfile->Close();
 
+  cout << acc.GetNHist() << " histograms written in output.root" << endl;
 
+  return 0;
+
+}//HistMode
+
+//_____________________________________________________________________________
+int AccMode(const string& mapname, int nev, unsigned int nthr) {
+
+  //acceptance map in (pT^2, y, cos(theta)) from nev generated decays in nthr threads,
+  //all decays are counted and those with both daughters in eta range are accepted
+
+  TAccMap acc(20, 0, 0.01, 24, -1.2, 1.2, 20); // pT^2, y and cos(theta) bins within generated range
+  acc.SetNSlots(nthr);
+
+  ROOT::EnableThreadSafety();
+
+  vector<TGenUPCJpsiFlat*> gen(nthr);
+  for(unsigned int ithr=0; ithr<nthr; ithr++) {
+    gen[ithr] = new TGenUPCJpsiFlat(0.01, -1.2, 1.2, ""); // max pT^2 and eta range
+    gen[ithr]->SetSeed(5572323 + 100*ithr);
+  }
+
+  vector<thread> workers;
+  for(unsigned int ithr=0; ithr<nthr; ithr++) {
+
+    int nthrev = nev/int(nthr) + (int(ithr) < nev%int(nthr) ? 1 : 0);
+
+    workers.push_back( thread([&acc, &gen, ithr, nthrev] {
+
+      Double_t val[3];
+      for(int i=0; i<nthrev; i++) {
+        bool accepted = gen[ithr]->GenerateTrial();
+        TAccMap::Vars(gen[ithr]->GetParticle(0), gen[ithr]->GetParticle(1), val);
+        acc.Fill(ithr, val, accepted);
+      }
+
+    }) );
+  }
+
+  for(unsigned int ithr=0; ithr<nthr; ithr++) {
+    workers[ithr].join();
+    delete gen[ithr];
+  }
+
+  acc.Merge();
+  if( !acc.Save(mapname) ) return -1;
+
+  //the same map as histogram for inspection
+  TFile *outfile = TFile::Open("output.root", "recreate");
+  acc.Write();
+  outfile->Close();
+
+  cout << "acceptance map from " << acc.GetNTrials() << " decays written in " << mapname << endl;
+
+  return 0;
+
+}//AccMode
+
+
+//_____________________________________________________________________________
+int PostMode(const string& inp, const string& outp, int pdg) {
+
+  //derived variables recomputed from daughter pT, eta and phi in existing bgen_tree,
+  //only the daughter branches are read, the remaining ones are computed in batches;
+  //pdg is the daughter code, by default from the tree user info or the boxgen generator
+
+  TFile *infile = TFile::Open(inp.c_str());
+  if( !infile or infile->IsZombie() ) return -1;
+
+  TTree *intree = dynamic_cast<TTree*>( infile->Get("bgen_tree") );
+  if( !intree ) {
+    cout << "no bgen_tree in " << inp << endl;
+    return -1;
+  }
+
+  //daughter baskets read in bulk through the tree cache, not entry by entry from the file;
+  //GetEntry below only unpacks the six cached values of an entry to the batch, ROOT bulk
+  //I/O (TBranch::GetBulkRead) is experimental and not used
+  intree->SetCacheSize(64*1024*1024);
+
+  //daughter branches, pT, eta and phi for each
+  Double_t din[2][3];
+  intree->SetBranchStatus("*", 0);
+  for(int i=0; i<2; i++) {
+    for(int j=0; j<3; j++) {
+      const char *bname = TKinColumns::GetVarName(3*i+j);
+      intree->SetBranchStatus(bname, 1);
+      intree->SetBranchAddress(bname, &din[i][j]);
+      intree->AddBranchToCache(bname);
+    }
+  }
+
+  intree->StopCacheLearningPhase();
+
+  //daughter mass, as written with the tree, files without it come from TGenUPCJpsiFlat
+  if( pdg == 0 ) {
+    TParameter<Int_t> *par = dynamic_cast<TParameter<Int_t>*>( intree->GetUserInfo()->FindObject("leptonPdg") );
+    pdg = par ? par->GetVal() : TGenUPCJpsiFlat::kLeptonPdg;
+  }
+  Double_t mass = TPdgTable::Mass(pdg);
+
+  TFile *outfile = TFile::Open(outp.c_str(), "recreate");
+  Double_t val[nvar];
+  TTree *bgen_tree = MakeTree(val, pdg);
+
+  TKinColumns kin;
+  Long64_t nent = intree->GetEntries();
+  for(Long64_t i=0; i<nent; i++) {
+    intree->GetEntry(i);
+    kin.AddPtEtaPhi(din[0], din[1], mass);
+    if( kin.IsFull() ) FillTree(kin, bgen_tree, val);
+  }
+  FillTree(kin, bgen_tree, val);
+
+  bgen_tree->Write();
+  outfile->Close();
+  infile->Close();
+
+  cout << nent << " entries from " << inp << " written in " << outp << endl;
+
+  return 0;
 
+}//PostMode
@@ -2,33 +2,137 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <cstdlib>
+#include <cstdio>
+
+#include "TFile.h"
+#include "TH2.h"
 
 #include "TGenPsi2S.h"
+#include "TKinSampler.h"
 
 using namespace std;
 
 //_____________________________________________________________________________
 int main(int argc, char* argv[]) {
 
-	std::string inFile, outFile;
+	std::string inFile, outFile, histCfg, polCfg, cutsCfg, idxName, chanCfg, cacheName, decay, smpName, mkSmpName, smpBins;
+	unsigned long nev = 0;
+	unsigned int stream = 0;
 
 	if(argc==1){
 		inFile = "/afs/cern.ch/user/s/shuaiy/public/starlight/decayPsi2S/testFiles/slight_CohPsi2S_4Feeddown_0001.out";
 		outFile = "test";
 	}
-	else if(argc==3){
+	else if(argc>=3 && argc%2==1){
 		inFile  = std::string(argv[1]);
 		outFile = std::string(argv[2]);
+
+		//optional settings as pairs after input and output
+		for(int i=3; i<argc; i+=2){
+			std::string opt(argv[i]);
+			if(opt=="-hist") histCfg = std::string(argv[i+1]); // histograms only, no tree and .tx
+			else if(opt=="-pol") polCfg = std::string(argv[i+1]); // frame and polarization hypotheses for weights
+			else if(opt=="-cuts") cutsCfg = std::string(argv[i+1]); // selection before the output
+			else if(opt=="-index") idxName = std::string(argv[i+1]); // event index along the .tx output, with -channels one <channel>.tx.idx per channel
+			else if(opt=="-cache") cacheName = std::string(argv[i+1]); // binary cache of parsed input, used when valid, written otherwise
+			else if(opt=="-decay") decay = std::string(argv[i+1]); // parent decays by 'decayer' (default) or 'pythia8' directly
+			else if(opt=="-mksampler") mkSmpName = std::string(argv[i+1]); // parent (pT, y) spectrum of the input to a sampler file, no generation
+			else if(opt=="-smpbins") smpBins = std::string(argv[i+1]); // sampler binning for -mksampler: npt,ptmin,ptmax,ny,ymin,ymax
+			else if(opt=="-sampler") smpName = std::string(argv[i+1]); // parents generated from sampler file or file.root:hist2d (pT on x, y on y), input is not read
+			else if(opt=="-nev") nev = strtoul(argv[i+1], 0x0, 10); // number of parents from the sampler
+			else if(opt=="-stream") stream = strtoul(argv[i+1], 0x0, 10); // random stream of the sampler, different for parallel jobs
+			else if(opt=="-channels") chanCfg = std::string(argv[i+1]); // decay channels with own outputs, replaces the output name
+			else{
+				cout<<"unknown option "<<opt<<endl;
+				return -1;
+			}
+		}
 	}
 	else{
-		cout<<"arge should be equal to 1 or 3 !"<<endl;
+		cout<<"usage: fdgen [input output [-hist hist.cfg] [-pol pol.cfg] [-cuts cuts.cfg] [-index test.tx.idx] [-channels channels.cfg] [-cache input.out.cache] [-decay decayer|pythia8] [-mksampler psi2s.smp [-smpbins npt,ptmin,ptmax,ny,ymin,ymax]] [-sampler psi2s.smp -nev N [-stream i]]]"<<endl;
 		return -1;
 	}
 
 	TGenPsi2S *gen = new TGenPsi2S(inFile, outFile, 0);
 
+	//channels are loaded first, the other options apply to all of them
+	if(!chanCfg.empty() && !gen->LoadChannels(chanCfg)){
+		delete gen;
+		return -1;
+	}
+
 	//gen->SetEtaRange(-2.5, 2.5);
 
+	if(!histCfg.empty() && !gen->SetHistConfig(histCfg)){
+		delete gen;
+		return -1;
+	}
+
+	if(!polCfg.empty() && !gen->SetPolConfig(polCfg)){
+		delete gen;
+		return -1;
+	}
+
+	if(!cutsCfg.empty() && !gen->SetCuts(cutsCfg)){
+		delete gen;
+		return -1;
+	}
+
+	if(!idxName.empty()) gen->SetTxIndex(idxName);
+
+	if(decay=="pythia8") gen->SetDecay(TGenPsi2S::kPythia8);
+	else if(!decay.empty() && decay!="decayer"){
+		cout<<"unknown decay "<<decay<<endl;
+		delete gen;
+		return -1;
+	}
+
+	//text input is parsed also when the cache can not be written
+	if(!cacheName.empty()) gen->SetInputCache(cacheName);
+
+	//sampler from the whole input, saved for later generation
+	if(!mkSmpName.empty()){
+		int npt=300, ny=120;
+		double ptmin=0, ptmax=1.5, ymin=-6, ymax=6;
+		if(!smpBins.empty() && (sscanf(smpBins.c_str(), "%d,%lf,%lf,%d,%lf,%lf", &npt, &ptmin, &ptmax, &ny, &ymin, &ymax) != 6
+		   || npt<1 || ny<1 || ptmax<=ptmin || ymax<=ymin)){
+			cout<<"invalid sampler binning "<<smpBins<<endl;
+			delete gen;
+			return -1;
+		}
+		TKinSampler smp(npt, ptmin, ptmax, ny, ymin, ymax);
+		bool stat = gen->FillSampler(smp) && smp.Save(mkSmpName);
+		delete gen;
+		return stat ? 0 : -1;
+	}
+
+	//parents generated by the sampler instead of the input
+	if(!smpName.empty()){
+		if(nev==0){
+			cout<<"number of events (-nev) is needed for the sampler"<<endl;
+			delete gen;
+			return -1;
+		}
+		TKinSampler *smp = new TKinSampler();
+		bool stat = false;
+		size_t pos = smpName.find(".root:");
+		if(pos != std::string::npos){
+			TFile hfile(smpName.substr(0, pos+5).c_str());
+			TH2 *hx = 0x0;
+			hfile.GetObject(smpName.substr(pos+6).c_str(), hx);
+			if(hx) stat = smp->FromHist(hx);
+			else cout<<"no histogram "<<smpName<<endl;
+		}
+		else stat = smp->Load(smpName);
+		if(!stat){
+			delete smp;
+			delete gen;
+			return -1;
+		}
+		gen->SetSampler(smp, nev, stream);
+	}
+
 	gen->EventLoop();
 
 	delete gen;
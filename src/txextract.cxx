@@ -0,0 +1,115 @@
+
+//C++ headers
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+//local headers
+#include "TCompStream.h"
+#include "TTxIndex.h"
+
+using namespace std;
+
+//_____________________________________________________________________________
+int main(int argc, char* argv[]) {
+
+  //events from .tx output selected with the event index, copied without reading
+  //the rest of the file:
+  //
+  //  ./txextract test.tx out.tx -ev first last   # range of event numbers
+  //  ./txextract test.tx out.tx -y ymin ymax [-pt ptmin ptmax]   # kinematic slice
+  //
+  //index is read from test.tx.idx, compressed input and output by extension;
+  //plain input is accessed directly at indexed offsets, compressed input is
+  //decompressed forward up to each selected event, zstd input can not go back
+
+  if( argc < 6 or argc%3 != 0 ) {
+    cout << "usage: txextract input.tx output.tx [-ev first last] [-y ymin ymax] [-pt ptmin ptmax]" << endl;
+    return 2;
+  }
+
+  string inp = argv[1];
+  string outp = argv[2];
+
+  unsigned long evmin = 0, evmax = 0;
+  Double_t ymin = -1e9, ymax = 1e9, ptmin = 0, ptmax = 1e9;
+  bool useev = false;
+
+  for(int i=3; i<argc; i+=3) {
+    string opt(argv[i]);
+    if( opt == "-ev" ) {
+      evmin = strtoul(argv[i+1], 0x0, 10);
+      evmax = strtoul(argv[i+2], 0x0, 10);
+      useev = true;
+    } else if( opt == "-y" ) {
+      ymin = atof(argv[i+1]);
+      ymax = atof(argv[i+2]);
+    } else if( opt == "-pt" ) {
+      ptmin = atof(argv[i+1]);
+      ptmax = atof(argv[i+2]);
+    } else {
+      cout << "txextract: unknown option " << opt << endl;
+      return 2;
+    }
+  }
+
+  TTxIndex idx;
+  if( !idx.Load(TTxIndex::IndexName(inp)) ) return 1;
+
+  //selected records, in the order of offsets
+  unsigned long ifirst = 0, ilast = idx.GetN();
+  if( useev ) {
+    long i0 = idx.Find(evmin);
+    long i1 = idx.Find(evmax);
+    if( i0 < 0 or i1 < i0 ) {
+      cout << "txextract: events " << evmin << " - " << evmax << " not in the index" << endl;
+      return 1;
+    }
+    ifirst = i0;
+    ilast = i1 + 1;
+  }
+
+  vector<unsigned long> sel;
+  for(unsigned long i=ifirst; i<ilast; i++) {
+    const TTxIndex::Record& rec = idx.At(i);
+    if( rec.y < ymin or rec.y >= ymax ) continue;
+    if( rec.pt < ptmin or rec.pt >= ptmax ) continue;
+    sel.push_back(i);
+  }
+
+  TCompInput in(inp);
+  if( !in.IsOpen() ) {
+    cout << "txextract: can not open " << inp << endl;
+    return 1;
+  }
+  TCompOutput out(outp);
+
+  //copy each selected event up to the start of the next indexed event
+  string line;
+  for(unsigned long isel=0; isel<sel.size(); isel++) {
+
+    unsigned long i = sel[isel];
+    if( !in.Seek(idx.At(i).offset) ) {
+      cout << "txextract: can not reach event " << idx.At(i).ntx << endl;
+      return 1;
+    }
+
+    bool last = i+1 >= idx.GetN();
+    while( in.GetLine(line) ) {
+      line += "\n";
+      out.Write(line);
+      if( !last and in.Tell() >= idx.At(i+1).offset ) break;
+    }
+  }
+
+  if( !out.Close() ) {
+    cout << "txextract: write error in " << outp << endl;
+    return 1;
+  }
+
+  cout << "txextract: " << sel.size() << " events written to " << outp << endl;
+
+  return 0;
+
+}//main
@@ -0,0 +1,492 @@
+
+//C++ headers
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+//ROOT headers
+#include "TFile.h"
+#include "TTree.h"
+#include "TChain.h"
+#include "TROOT.h"
+
+//local headers
+#include "TCompStream.h"
+#include "TTxIndex.h"
+
+using namespace std;
+
+int MergeTx(const string& outp, const vector<string>& inp, unsigned int nthr);
+int SplitTx(const string& inp, unsigned long nev);
+bool CountEvents(const string& inp, unsigned long& nev);
+bool Renumber(const string& inp, const string& outp, unsigned long ntx, unsigned long& nev);
+bool SetToken(string& line, int itok, unsigned long val);
+bool AppendFile(const string& inp, FILE *out);
+string RootName(const string& tx);
+bool MergeRoot(const string& outp, const vector<string>& inp);
+
+//_____________________________________________________________________________
+int main(int argc, char* argv[]) {
+
+  //merge of .tx shards with unique event numbers and split of large .tx to chunks,
+  //the corresponding .root files with jGenTree are merged or split along:
+  //
+  //  ./txmerge -merge [-j nthreads] merged.tx shard_1.tx shard_2.tx ...
+  //  ./txmerge -split input.tx nev
+  //
+  //compression of all .tx files is given by extension
+
+  if( argc > 3 and string(argv[1]) == "-merge" ) {
+
+    int iarg = 2;
+    unsigned int nthr = 1;
+    if( string(argv[iarg]) == "-j" and argc > 4 ) {
+      long nj = strtol(argv[iarg+1], 0x0, 10);
+      if( nj < 1 or nj > 256 ) {
+        cout << "txmerge: invalid number of threads " << argv[iarg+1] << ", allowed 1 - 256" << endl;
+        return 2;
+      }
+      nthr = nj;
+      iarg += 2;
+    }
+
+    string outp = argv[iarg++];
+    vector<string> inp(argv+iarg, argv+argc);
+    if( inp.empty() ) {
+      cout << "txmerge: no input shards" << endl;
+      return 2;
+    }
+
+    return MergeTx(outp, inp, nthr);
+  }
+
+  if( argc == 4 and string(argv[1]) == "-split" ) {
+
+    unsigned long nev = strtoul(argv[3], 0x0, 10);
+    if( nev == 0 ) {
+      cout << "txmerge: invalid number of events per chunk" << endl;
+      return 2;
+    }
+
+    return SplitTx(argv[2], nev);
+  }
+
+  cout << "usage: txmerge -merge [-j nthreads] merged.tx shard_1.tx shard_2.tx ..." << endl;
+  cout << "       txmerge -split input.tx nev" << endl;
+
+  return 2;
+
+}//main
+
+//_____________________________________________________________________________
+int MergeTx(const string& outp, const vector<string>& inp, unsigned int nthr) {
+
+  //each shard is renumbered in parallel to a temporary part with the output compression,
+  //the parts are appended to the output in order as they are completed, gzip and zstd
+  //allow for concatenation of compressed streams
+
+  unsigned int nshard = inp.size();
+
+  //events in each shard, from the index when available
+  vector<unsigned long> nevt(nshard);
+  vector<char> counted(nshard, 0);
+  atomic<unsigned int> inext(0);
+  vector<thread> workers;
+  for(unsigned int ithr=0; ithr<nthr; ithr++) {
+    workers.push_back( thread([&] {
+      for(unsigned int i=inext++; i<nshard; i=inext++) counted[i] = CountEvents(inp[i], nevt[i]);
+    }) );
+  }
+  for(unsigned int ithr=0; ithr<workers.size(); ithr++) workers[ithr].join();
+  workers.clear();
+
+  //no output when any shard is unreadable
+  for(unsigned int i=0; i<nshard; i++) {
+    if( !counted[i] ) {
+      cout << "txmerge: shard " << inp[i] << " is unreadable, nothing merged" << endl;
+      return 1;
+    }
+  }
+
+  //first event number of each shard
+  vector<unsigned long> first(nshard);
+  unsigned long ntot = 0;
+  for(unsigned int i=0; i<nshard; i++) {
+    first[i] = ntot + 1;
+    ntot += nevt[i];
+  }
+
+  //temporary parts, output.tx.gz -> output.tx.part<i>.gz
+  string suffix;
+  string base = TCompStream::StripSuffix(outp, suffix);
+  vector<string> part(nshard);
+  for(unsigned int i=0; i<nshard; i++) part[i] = base + ".part" + to_string(i) + suffix;
+
+  FILE *out = fopen(outp.c_str(), "wb");
+  if( !out ) {
+    cout << "txmerge: can not write " << outp << endl;
+    return 1;
+  }
+
+  //renumbering in parallel, completed parts are marked for the output
+  //together with the number of renumbered events
+  vector<bool> done(nshard, false);
+  vector<bool> renumbered(nshard, false);
+  vector<unsigned long> nren(nshard, 0);
+  mutex mtx;
+  condition_variable cond;
+
+  inext = 0;
+  for(unsigned int ithr=0; ithr<nthr; ithr++) {
+    workers.push_back( thread([&] {
+      for(unsigned int i=inext++; i<nshard; i=inext++) {
+        unsigned long nev = 0;
+        bool ok = Renumber(inp[i], part[i], first[i], nev);
+        {
+          lock_guard<mutex> lock(mtx);
+          renumbered[i] = ok;
+          nren[i] = nev;
+          done[i] = true;
+        }
+        cond.notify_all();
+      }
+    }) );
+  }
+
+  //parts to the output in the order of shards, after the first failure
+  //the remaining parts are only removed
+  bool stat = true;
+  for(unsigned int i=0; i<nshard; i++) {
+    {
+      unique_lock<mutex> lock(mtx);
+      cond.wait(lock, [&]{ return done[i]; });
+    }
+    if( stat and !renumbered[i] ) {
+      cout << "txmerge: shard " << inp[i] << " is unreadable" << endl;
+      stat = false;
+    }
+    //stale index gives duplicate or missing event numbers
+    if( stat and nren[i] != nevt[i] ) {
+      cout << "txmerge: " << nren[i] << " events in " << inp[i] << ", expected " << nevt[i] << endl;
+      stat = false;
+    }
+    if( stat and !AppendFile(part[i], out) ) {
+      cout << "txmerge: failed to write " << outp << endl;
+      stat = false;
+    }
+    unlink(part[i].c_str());
+  }
+
+  for(unsigned int ithr=0; ithr<workers.size(); ithr++) workers[ithr].join();
+  fclose(out);
+
+  if( !stat ) {
+    unlink(outp.c_str());
+    cout << "txmerge: merge failed, " << outp << " removed" << endl;
+    return 1;
+  }
+
+  cout << "txmerge: " << ntot << " events from " << nshard << " shards written to " << outp << endl;
+
+  //trees in corresponding .root files
+  if( !MergeRoot(RootName(outp), inp) ) return 1;
+
+  return 0;
+
+}//MergeTx
+
+//_____________________________________________________________________________
+int SplitTx(const string& inp, unsigned long nev) {
+
+  //chunks of nev events at event boundaries, event numbers are kept, names
+  //are input_<i>.tx with the compression of the input
+
+  TCompInput in(inp);
+  if( !in.IsOpen() ) {
+    cout << "txmerge: can not open " << inp << endl;
+    return 1;
+  }
+
+  string suffix;
+  string base = TCompStream::StripSuffix(inp, suffix);
+  if( base.size() > 3 and base.compare(base.size()-3, 3, ".tx") == 0 ) base.erase(base.size()-3);
+
+  vector<string> chunks;
+  TCompOutput *out = 0x0;
+  unsigned long iev = 0;
+  bool stat = true;
+
+  string line;
+  while( in.GetLine(line) ) {
+
+    //new chunk at the event boundary
+    if( line.compare(0, 6, "EVENT:") == 0 ) {
+      if( iev % nev == 0 ) {
+        if( out and !out->Close() ) stat = false;
+        delete out;
+        char num[16];
+        snprintf(num, sizeof(num), "_%04lu", (unsigned long)chunks.size()+1);
+        chunks.push_back( base + num + ".tx" + suffix );
+        out = new TCompOutput(chunks.back());
+      }
+      iev++;
+    }
+    if( !out ) continue;
+
+    line += "\n";
+    out->Write(line);
+  }
+  if( out and !out->Close() ) stat = false;
+  delete out;
+
+  if( !stat ) {
+    cout << "txmerge: write error in chunks of " << inp << endl;
+    return 1;
+  }
+
+  cout << "txmerge: " << iev << " events from " << inp << " split to " << chunks.size() << " chunks" << endl;
+
+  //tree in corresponding .root file, one entry per event
+  if( access(RootName(inp).c_str(), R_OK) != 0 ) return 0;
+  TFile *infile = TFile::Open(RootName(inp).c_str());
+  if( !infile or infile->IsZombie() ) return 0;
+
+  TTree *intree = 0x0;
+  infile->GetObject("jGenTree", intree);
+  if( !intree ) return 0;
+
+  Long64_t nent = intree->GetEntries();
+  for(unsigned int i=0; i<chunks.size(); i++) {
+
+    TFile outfile(RootName(chunks[i]).c_str(), "recreate");
+    TTree *outtree = intree->CloneTree(0);
+    for(Long64_t ient=i*nev; ient<nent and ient<Long64_t((i+1)*nev); ient++) {
+      intree->GetEntry(ient);
+      outtree->Fill();
+    }
+    outtree->Write();
+    outfile.Close();
+  }
+
+  infile->Close();
+
+  return 0;
+
+}//SplitTx
+
+//_____________________________________________________________________________
+bool CountEvents(const string& inp, unsigned long& nev) {
+
+  //number of EVENT lines, the index gives the number without reading the shard,
+  //false when the shard can not be opened
+
+  nev = 0;
+
+  if( access(inp.c_str(), R_OK) != 0 ) {
+    cout << "txmerge: can not open " << inp << endl;
+    return false;
+  }
+
+  if( access(TTxIndex::IndexName(inp).c_str(), R_OK) == 0 ) {
+    TTxIndex idx;
+    if( idx.Load(TTxIndex::IndexName(inp)) ) {
+      nev = idx.GetN();
+      return true;
+    }
+  }
+
+  TCompInput in(inp);
+  if( !in.IsOpen() ) {
+    cout << "txmerge: can not open " << inp << endl;
+    return false;
+  }
+
+  string line;
+  while( in.GetLine(line) ) {
+    if( line.compare(0, 6, "EVENT:") == 0 ) nev++;
+  }
+
+  if( in.IsBad() ) {
+    cout << "txmerge: " << inp << " is truncated or corrupted" << endl;
+    return false;
+  }
+
+  return true;
+
+}//CountEvents
+
+//_____________________________________________________________________________
+bool Renumber(const string& inp, const string& outp, unsigned long ntx, unsigned long& nev) {
+
+  //events numbered from ntx, in EVENT lines and in the event field of TRACK lines,
+  //nev is the number of renumbered events
+
+  nev = 0;
+
+  TCompInput in(inp);
+  if( !in.IsOpen() ) {
+    cout << "txmerge: can not open " << inp << endl;
+    return false;
+  }
+
+  TCompOutput out(outp);
+  if( !out.IsOpen() ) {
+    cout << "txmerge: can not write " << outp << endl;
+    return false;
+  }
+
+  unsigned long iev = ntx - 1;
+
+  string line;
+  while( in.GetLine(line) ) {
+
+    if( line.compare(0, 6, "EVENT:") == 0 ) {
+      SetToken(line, 1, ++iev);
+    } else if( line.compare(0, 6, "TRACK:") == 0 ) {
+      SetToken(line, 5, iev);
+    }
+
+    line += "\n";
+    out.Write(line);
+  }
+
+  if( !out.Close() ) {
+    cout << "txmerge: write error in " << outp << endl;
+    return false;
+  }
+
+  nev = iev - (ntx - 1);
+
+  if( in.IsBad() ) {
+    cout << "txmerge: " << inp << " is truncated or corrupted" << endl;
+    return false;
+  }
+
+  return true;
+
+}//Renumber
+
+//_____________________________________________________________________________
+bool SetToken(string& line, int itok, unsigned long val) {
+
+  //replace space-separated token at position itok, the rest of the line is kept
+
+  size_t beg = 0;
+  for(int i=0; ; i++) {
+
+    beg = line.find_first_not_of(' ', beg);
+    if( beg == string::npos ) return false;
+
+    size_t end = line.find(' ', beg);
+    if( end == string::npos ) end = line.size();
+
+    if( i == itok ) {
+      line.replace(beg, end-beg, to_string(val));
+      return true;
+    }
+
+    beg = end;
+  }
+
+}//SetToken
+
+//_____________________________________________________________________________
+bool AppendFile(const string& inp, FILE *out) {
+
+  //raw copy of a complete file
+
+  FILE *in = fopen(inp.c_str(), "rb");
+  if( !in ) return false;
+
+  vector<char> buf(1<<20);
+  size_t nread;
+  while( (nread = fread(&buf[0], 1, buf.size(), in)) > 0 ) {
+    if( fwrite(&buf[0], 1, nread, out) != nread ) {
+      fclose(in);
+      return false;
+    }
+  }
+
+  fclose(in);
+
+  return true;
+
+}//AppendFile
+
+//_____________________________________________________________________________
+string RootName(const string& tx) {
+
+  //ROOT output for the .tx, test.tx.gz -> test.root
+
+  string suffix;
+  string base = TCompStream::StripSuffix(tx, suffix);
+  if( base.size() > 3 and base.compare(base.size()-3, 3, ".tx") == 0 ) base.erase(base.size()-3);
+
+  return base + ".root";
+
+}//RootName
+
+//_____________________________________________________________________________
+bool MergeRoot(const string& outp, const vector<string>& inp) {
+
+  //jGenTree from all shards by fast merge of baskets, polHypo from the first shard,
+  //false when only some shards have the .root file or the merge failed
+
+  vector<string> names;
+  unsigned int nmiss = 0;
+  for(unsigned int i=0; i<inp.size(); i++) {
+    names.push_back( RootName(inp[i]) );
+    if( access(names.back().c_str(), R_OK) != 0 ) nmiss++;
+  }
+
+  //shards without ROOT output
+  if( nmiss == names.size() ) {
+    cout << "txmerge: no .root files for the shards, ROOT files are not merged" << endl;
+    return true;
+  }
+  if( nmiss > 0 ) {
+    cout << "txmerge: " << nmiss << " shards without .root file, ROOT files are not merged" << endl;
+    return false;
+  }
+
+  TChain chain("jGenTree");
+  for(unsigned int i=0; i<names.size(); i++) chain.Add(names[i].c_str());
+  if( chain.Merge(outp.c_str(), "fast") <= 0 ) {
+    cout << "txmerge: merge of jGenTree to " << outp << " failed" << endl;
+    return false;
+  }
+
+  bool stat = true;
+  TFile *first = TFile::Open(names[0].c_str());
+  if( !first or first->IsZombie() ) {
+    cout << "txmerge: can not open " << names[0] << endl;
+    return false;
+  }
+  TTree *polHypo = 0x0;
+  first->GetObject("polHypo", polHypo);
+  if( polHypo ) {
+    TFile out(outp.c_str(), "update");
+    TTree *hypo = polHypo->CloneTree(-1, "fast");
+    if( !hypo or hypo->Write() <= 0 ) {
+      cout << "txmerge: can not write polHypo to " << outp << endl;
+      stat = false;
+    }
+    out.Close();
+  }
+  first->Close();
+
+  if( !stat ) return false;
+
+  cout << "txmerge: jGenTree from " << names.size() << " files written to " << outp << endl;
+
+  return true;
+
+}//MergeRoot
@@ -0,0 +1,140 @@
+
+//C++ headers
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+//ROOT headers
+#include "TFile.h"
+#include "TStopwatch.h"
+
+//local headers
+#include "TGenPsi2S.h"
+#include "TEventStream.h"
+#include "TValidator.h"
+#include "TKinSampler.h"
+
+using namespace std;
+
+TBatchSource* MakeSource(const string& path, const string& inp, unsigned long nev);
+int RunPath(int argc, char* argv[]);
+int ComparePaths(int argc, char* argv[]);
+
+//_____________________________________________________________________________
+int main(int argc, char* argv[]) {
+
+  //statistical equivalence of a candidate generation path with the reference,
+  //each path runs in a separate process since only one Pythia8 instance is allowed:
+  //
+  //  ./valgen -run ref input.out ref.root [nev] [etamin etamax]
+  //  ./valgen -run <candidate> input.out cand.root [nev] [etamin etamax]
+  //  ./valgen -compare ref.root cand.root [pmin]
+  //
+  //candidates are listed in MakeSource: pythia, sampler
+  //exit code is non-zero when the candidate differs from the reference
+
+  if( argc > 4 and string(argv[1]) == "-run" ) return RunPath(argc, argv);
+  if( argc > 3 and string(argv[1]) == "-compare" ) return ComparePaths(argc, argv);
+
+  cout << "usage: valgen -run <path> input output.root [nev] [etamin etamax]" << endl;
+  cout << "       valgen -compare ref.root cand.root [pmin]" << endl;
+
+  return 2;
+
+}//main
+
+//_____________________________________________________________________________
+TBatchSource* MakeSource(const string& path, const string& inp, unsigned long nev) {
+
+  //generation paths available for validation
+
+  if( path == "ref" ) {
+    //TDecayPolarized + TPythia8Decayer, the production configuration
+    return new TGenPsi2S(inp, "", nev);
+  }
+
+  if( path == "pythia" ) {
+    //Pythia8 event record used directly, no TClonesArray import
+    TGenPsi2S *gen = new TGenPsi2S(inp, "", nev);
+    gen->SetDecay(TGenPsi2S::kPythia8);
+    return gen;
+  }
+
+  if( path == "sampler" ) {
+    //parents from the (pT, y) spectrum of the input, generated in memory
+    TGenPsi2S *gen = new TGenPsi2S(inp, "", nev);
+    TKinSampler *smp = new TKinSampler();
+    if( !gen->FillSampler(*smp) ) {
+      delete smp;
+      delete gen;
+      return 0x0;
+    }
+    gen->SetSampler(smp, nev, 0);
+    return gen;
+  }
+
+  return 0x0;
+
+}//MakeSource
+
+//_____________________________________________________________________________
+int RunPath(int argc, char* argv[]) {
+
+  string path = argv[2];
+  string inp = argv[3];
+  string outp = argv[4];
+
+  unsigned long nev = 100000;
+  if( argc > 5 ) nev = strtoul(argv[5], 0x0, 10);
+
+  TBatchSource *src = MakeSource(path, inp, nev);
+  if( !src ) {
+    cout << "valgen: unknown path " << path << endl;
+    return 2;
+  }
+
+  //pseudorapidity interval for the leptons, the same for all paths
+  TGenPsi2S *gen = dynamic_cast<TGenPsi2S*>(src);
+  if( gen and argc > 7 ) gen->SetEtaRange(atof(argv[6]), atof(argv[7]));
+
+  TValidator val;
+
+  TStopwatch sw;
+  sw.Start();
+
+  TEventStream stream(src, 1000, nev);
+  for(TEventStream::iterator it = stream.begin(); it != stream.end(); ++it) {
+    val.Fill(*it);
+  }
+
+  sw.Stop();
+  val.SetTiming(sw.RealTime(), stream.GetNEvents());
+
+  cout << path << ": " << stream.GetNEvents() << " events in " << sw.RealTime() << " s" << endl;
+
+  delete src;
+
+  TFile out(outp.c_str(), "recreate");
+  val.Write();
+  out.Close();
+
+  return 0;
+
+}//RunPath
+
+//_____________________________________________________________________________
+int ComparePaths(int argc, char* argv[]) {
+
+  Double_t pmin = 1e-3;
+  if( argc > 4 ) pmin = atof(argv[4]);
+
+  TFile fref(argv[2]);
+  TFile fcand(argv[3]);
+
+  TValidator ref, cand;
+  if( !ref.Load(&fref) or !cand.Load(&fcand) ) return 2;
+
+  return TValidator::Compare(ref, cand, pmin) ? 0 : 1;
+
+}//ComparePaths
+